@@ -19,7 +19,7 @@
  * FOR DIFFERENT HARDWARE, YOU CAN CHANGE THE PINS IN THE FILE hardware.h
  *
  */
-#include "hardware.h"
+#include "hal.h"
 #include "SSD1306.h"
 #include "bitmaps.h"
 #include "alien_grid.h"
@@ -28,7 +28,14 @@
 #include "bomb.h"
 #include "mystery.h"
 #include "sound.h"
-#include <EEPROM.h>
+#include "rng.h"
+#include "input.h"
+#include "latency.h"
+#include "scenario.h"
+#include "trace.h"
+#include "console.h"
+#include "high_scores.h"
+#include "modes.h"
 
 // How fast stuff moves (higher values are slower)
 #define COUNTDOWN_BASE_MOVE 19 // How fast the base moves in milliseconds per pixel
@@ -42,7 +49,7 @@
 #define COUNTDOWN_INTER_LEVEL 3000 // How long the delay between levels
 #define COUNTDOWN_MYSTERY_HIT 503 // How long the mystery ship points remains visible after being shot
 // Probabilities
-#define MYSTERY_PROBABILITY 20000 // The probability of a mystery ship appearing per iteration of the game loop 1:x
+#define MYSTERY_MEAN_INTERVAL 25000 // The average time in milliseconds before a mystery ship appears (once it's allowed to)
 #define BOMB_FACTOR 5 // The probability of an alien dropping a bomb (higher values = lower probability)
 
 #define MAX_BOMBS 4 // TThe maximum number of simultaneous alien bombs
@@ -51,54 +58,84 @@
 
 #define EXTRA_LIFE 1000 // Number of points to score to earn an extra life
 
+#ifdef CONSOLE
+/*
+ * With the console, the timings and probabilities above can be changed while
+ * the game runs (see console.h). They start off as above, then come from its
+ * table in RAM. The order must match the TUNE_ numbers.
+ */
+const int tunableDefaults[TUNABLES] PROGMEM = {
+  COUNTDOWN_BASE_MOVE, COUNTDOWN_LASER_MOVE, COUNTDOWN_MYSTERY_MOVE, COUNTDOWN_ALIEN_STEP,
+  COUNTDOWN_EXPLOSION, COUNTDOWN_BOMB_MOVE, COUNTDOWN_BASE_DEAD, COUNTDOWN_INTER_LEVEL,
+  COUNTDOWN_MYSTERY_HIT, MYSTERY_MEAN_INTERVAL, BOMB_FACTOR
+};
+#undef COUNTDOWN_BASE_MOVE
+#define COUNTDOWN_BASE_MOVE console.tunable[TUNE_BASE_MOVE]
+#undef COUNTDOWN_LASER_MOVE
+#define COUNTDOWN_LASER_MOVE console.tunable[TUNE_LASER_MOVE]
+#undef COUNTDOWN_MYSTERY_MOVE
+#define COUNTDOWN_MYSTERY_MOVE console.tunable[TUNE_MYSTERY_MOVE]
+#undef COUNTDOWN_ALIEN_STEP
+#define COUNTDOWN_ALIEN_STEP console.tunable[TUNE_ALIEN_STEP]
+#undef COUNTDOWN_EXPLOSION
+#define COUNTDOWN_EXPLOSION console.tunable[TUNE_EXPLOSION]
+#undef COUNTDOWN_BOMB_MOVE
+#define COUNTDOWN_BOMB_MOVE console.tunable[TUNE_BOMB_MOVE]
+#undef COUNTDOWN_BASE_DEAD
+#define COUNTDOWN_BASE_DEAD console.tunable[TUNE_BASE_DEAD]
+#undef COUNTDOWN_INTER_LEVEL
+#define COUNTDOWN_INTER_LEVEL console.tunable[TUNE_INTER_LEVEL]
+#undef COUNTDOWN_MYSTERY_HIT
+#define COUNTDOWN_MYSTERY_HIT console.tunable[TUNE_MYSTERY_HIT]
+#undef MYSTERY_MEAN_INTERVAL
+#define MYSTERY_MEAN_INTERVAL console.tunable[TUNE_MYSTERY_INTERVAL]
+#undef BOMB_FACTOR
+#define BOMB_FACTOR console.tunable[TUNE_BOMB_FACTOR]
+#endif
+
 /*
  * Variables and objects
  * Please note, all objects are predefined and reused in order to avoid heap
  * fragmentation.
  */
 SSD1306 screen(-1); // Screen object (No reset line)
+static_assert (SSD1306_LCDHEIGHT == 64, "The game is laid out for a 64 pixel high screen");
 AlienGrid aliens; // Create the alien grid object
 Base base; // Create the base object
 uint16_t score; // Current score value / 10
-uint8_t lives; // Lives remaining (including the current one)
 Defence defence[4]; // The defence objects
 Bomb bombs[MAX_BOMBS]; // The simultaneous bombs
 Mystery mystery; // The mystery ship object
-Sound sounds; // Sounds object
-uint8_t level; // Current level (level zero = demo mode)
-
-// Countdown timers
-int alienStepCountdown = 0; // Countdown till the next alien step
-int baseMoveCountdown = COUNTDOWN_BASE_MOVE; // Countdown until the base can move again
-int laserMoveCountdown = 0; // Countdown until the laser moves again
-int bombMoveCountdown = 0; // Countdown until the bombs can move again
-int explosionCountdown = COUNTDOWN_EXPLOSION; // Countdown until the alien explosion is removed
-int interLevelCountdown = COUNTDOWN_INTER_LEVEL; // Countdown until the next level starts
-int baseDeadCountdown = COUNTDOWN_BASE_DEAD; // Countdown until the base explosion sound stops
-int mysteryMoveCountdown = COUNTDOWN_MYSTERY_MOVE; // Countdown until the mystery ship can move again
-int mysteryHitCountdown = COUNTDOWN_MYSTERY_HIT; // Countdown until the mystery score is removed
-int soundCountdown = 30000; // Countdown until the sound stops (just set to a ridiculously high value, because nothing's happening)
-boolean fireButtonReleased; // A flag to indicate the the fire button has been released (fire button must be released prior to another shot)
 boolean screenUpdateRequired = false; // A flag to indicate that the screen has changed and requires update
-// Char buffer for high score name
-uint8_t highScoreName[3];
+boolean rendering = true; // False to play without drawing anything (see demoPlaySkip)
+uint16_t drawnScore; // The score and lives on the screen (see drawGame)
+uint8_t drawnLives;
+
+// The current mode, and the variables that belong to it (see modes.h)
+uint8_t mode;
+ModeState modeState;
 
 /*
  * Set up
  */
 void setup() {
 Serial.begin (9600);
-  // Button pin initialisation
-  pinMode (LEFT_PIN, INPUT_PULLUP);
-  pinMode (RIGHT_PIN, INPUT_PULLUP);
-  pinMode (FIRE_PIN, INPUT_PULLUP);
-  // Let the pins settle
-  delay (1);
+#ifdef CONSOLE
+  console.init (tunableDefaults);
+#endif
+  // Button initialisation
+  input.init ();
   // Check the EEPROM for a high score table (If the fire button is held down during power up, the high score table is cleared
-  highScoreInit (!digitalRead (FIRE_PIN));
+  highScores.init (input.held () & BUTTON_FIRE);
+  // Start the sound engine
+  sounds.init ();
   // Set up the screen
   screen.init();
   screen.clear();
+#ifdef SCENARIO_BENCH
+  // Measure the worst case scenarios first (see scenario.h)
+  scenarioRunAll ();
+#endif
   // Initialise demo mode
   demoStart();
 }
@@ -107,89 +144,153 @@ Serial.begin (9600);
  * Main loop
  */
 void loop () {
-  // If a game is being played
-  if (level) {
-    gameLoop ();
-  // Otherwise, check for new high scores or run the demo
-  } else {
-    if (score) {
-      // If this is set, the game is over, but the high score entry screen has not yet been initialised
-      if (fireButtonReleased) {
-        // If this is a new high score
-        if (isNewHighScore (score)) {
-          // Initialise the high score entry
-          initHighScoreGrid ();
-          fireButtonReleased = false;
-        } else {
-          // Not a new high score so make sure, we skip this in future and just run the demo
-          score = 0;
-        }
-      } else {
-        // Do the high score entry
-        highScoreLoop ();
-      }
-    } else {
-      // Demo mode
+  // Print any sound events (only when SOUND_TIMELINE is defined in sound.h)
+  SOUND_TIMELINE_REPORT ();
+#ifdef CONSOLE
+  // Run anything typed into the serial console (see console.h)
+  if (console.poll () == CONSOLE_BENCH) {
+#ifdef SCENARIO_BENCH
+    scenarioRunAll ();
+    demoStart ();
+    return;
+#endif
+  }
+#else
+  // Print the function trace if it's been asked for (only when TRACE_RAM is defined in trace.h)
+  TRACE_POLL ();
+#endif
+  switch (mode) {
+    case MODE_GAME:
+      gameLoop ();
+      break;
+    case MODE_DEMO_PLAY:
+      demoPlayLoop ();
+      break;
+    case MODE_GAME_OVER:
+      gameOverLoop ();
+      break;
+    case MODE_HIGH_SCORE:
+      highScoreLoop ();
+      break;
+    default:
       demoLoop ();
-    }
   }
 }
 
+/*
+ * Switch to another mode
+ * The mode's variables are cleared, ready for it to set up the ones it needs.
+ */
+void enterMode (uint8_t newMode) {
+  memset (&modeState, 0, sizeof (modeState));
+  mode = newMode;
+}
+
 /*
  * Game loop
  * The game plays until either all bases have been destroyed or the aliens reach the bottom.
  */
-void gameLoop() {
+void gameLoop () {
+  TRACE_SCOPE (TRACE_GAME_LOOP);
+  gameTick (readButtons ());
+}
+
+/*
+ * Move the game on by one go round the loop, with the given buttons pressed
+ * The demo plays through here too, with the buttons pressed by its script.
+ * When nothing is being drawn, there's no need to wait for anything, so time
+ * jumps straight to the next thing that happens.
+ * Returns the time it took (0 if the game ended)
+ */
+unsigned long gameTick (uint8_t buttons) {
   // Get the time, so that we can tell how long a single iteration took
-  unsigned long timeNow = millis ();
+  unsigned long timeNow = Clock::millis ();
+  unsigned long timeTaken;
+  // Time the frame for the console's statistics (only when CONSOLE is defined in console.h)
+  CONSOLE_FRAME_START ();
+
+  if (!gameStep (buttons)) return (0);
+
+  if (rendering) {
+    // Update screen if required
+    if (screenUpdateRequired) {
+      drawGame ();
+      screen.update ();
+      screenUpdateRequired = false;
+    }
+    CONSOLE_FRAME_END ();
+    // Calcualate the time taken again (including screen update time)
+    timeTaken = Clock::millis() - timeNow;
+    // If the the iteration took no time, then put in a 1 millisecond delay
+    if (timeTaken == 0) {
+      Clock::delay (1);
+      timeTaken = 1;
+    }
+  } else {
+    timeTaken = gameTimeToNext ();
+  }
+
+  gameAdvance (timeTaken);
+  return (timeTaken);
+}
+
+/*
+ * Do whatever is due in the game, with the given buttons pressed
+ * This is just the game - nothing is drawn (see drawGame).
+ * Returns false if the game ended
+ */
+boolean gameStep (uint8_t buttons) {
+  GameState &game = modeState.game;
 
   // Test for fire button press
-  if (base.fire (screen, !digitalRead (FIRE_PIN))) {
+  if (base.fire (buttons & BUTTON_FIRE)) {
     // Laser released, update the screen
     screenUpdateRequired = true;
     // ...and start the coundown
-    laserMoveCountdown = COUNTDOWN_LASER_MOVE;
-    soundCountdown = sounds.laserFire (soundCountdown);
+    game.laserMoveCountdown = COUNTDOWN_LASER_MOVE;
+    sounds.laserFire ();
   }
 
   // Move aliens
-  if (alienStepCountdown <= 0) {
-    aliens.step (screen);
+  if (game.alienStepCountdown <= 0) {
+    aliens.step ();
+    // The aliens wipe out any defences they walk over
+    for (uint8_t i = 0; i < 4; i ++) {
+      defence[i].clearRect (aliens.getLeft (), aliens.getTop (), aliens.getRight () - aliens.getLeft (), aliens.getBottom () - aliens.getTop ());
+    }
     // If the base isn't dead, make the sound
-    if (!base.isDead ()) soundCountdown = sounds.alienMarch (soundCountdown);
+    if (!base.isDead ()) sounds.alienMarch ();
     // If the aliens reach the bottom, then it's game over
     if (aliens.getBottom () >= BASE_Y) {
-      gameOver ();
-      return;
+      playOver ();
+      return (false);
     }
     // Set the countdown until the next step
-    alienStepCountdown = COUNTDOWN_ALIEN_STEP + (aliens.getAlienCount () * 4) + (COUNTDOWN_ALIEN_STEP / level);
+    game.alienStepCountdown = COUNTDOWN_ALIEN_STEP + (aliens.getAlienCount () * 4) + (COUNTDOWN_ALIEN_STEP / game.level);
     screenUpdateRequired = true;
   }
 
   // Move mystery
-  if (mysteryMoveCountdown <= 0) {
-    mystery.move (screen);
-    mysteryMoveCountdown = COUNTDOWN_MYSTERY_MOVE;
+  if (game.mysteryMoveCountdown <= 0) {
+    mystery.move ();
+    game.mysteryMoveCountdown = COUNTDOWN_MYSTERY_MOVE;
     screenUpdateRequired = true;
     // If the mystery ship has moved off the screen, stop the sound
     if (!mystery.exists ()) sounds.mysteryStop ();
   }
   
   // Remove alien explosion if present
-  if (explosionCountdown <= 0) {
+  if (game.explosionCountdown <= 0) {
     aliens.clearExplosion ();
     screenUpdateRequired = true;
     // Stop this from repeating unnecessarily, set the countdown ready for the next one
-    explosionCountdown = COUNTDOWN_EXPLOSION;
+    game.explosionCountdown = COUNTDOWN_EXPLOSION;
   }
 
   // Remove mystery score if present
-  if (mysteryHitCountdown <= 0) {
-    // Clear the whole top line.... fuck it!
-    screen.clearRect (0, 6, 128, 5);
+  if (game.mysteryHitCountdown <= 0) {
     // Set the countdown ready for the next one
-    mysteryHitCountdown = COUNTDOWN_MYSTERY_HIT;
+    game.mysteryHitCountdown = COUNTDOWN_MYSTERY_HIT;
     // Mark the myster ship as destroyed
     mystery.destroy ();
     // And stop the sound
@@ -198,35 +299,35 @@ void gameLoop() {
   }
   
   // Move base if left or right button pressed
-  if (baseMoveCountdown <= 0) {
-    if (base.moveBase (screen, !digitalRead (LEFT_PIN), !digitalRead (RIGHT_PIN))) {
+  if (game.baseMoveCountdown <= 0) {
+    if (base.moveBase (buttons & BUTTON_LEFT, buttons & BUTTON_RIGHT)) {
       // If it moved set the screen update flag
       screenUpdateRequired = true;
     }
-    baseMoveCountdown = COUNTDOWN_BASE_MOVE;
+    game.baseMoveCountdown = COUNTDOWN_BASE_MOVE;
   }
 
   // Move laser shot, if there is one
-  if (laserMoveCountdown <= 0) {
+  if (game.laserMoveCountdown <= 0) {
     // If there was a laser move
-    if (base.moveLaser (screen)) {
+    if (base.moveLaser ()) {
       // The screen needs updating
       screenUpdateRequired = true;
       // If the laser still exists (it could have gone off the top of the screen)
       if (base.getLaserY ()) {
         // Check for collisions with aliens
-        uint16_t hit = aliens.collisionDetect (screen, base.getLaserX (), base.getLaserY ());
+        uint16_t hit = aliens.collisionDetect (base.getLaserX (), base.getLaserY ());
         // Did we hit an alien?
         if (hit) {
           // Yay!
           // Remove the laser shot
           base.destroyLaser ();
           // Make the noise of a dying alien
-          soundCountdown = sounds.alienKilled (soundCountdown);
+          sounds.alienKilled ();
           // Update the score with the hit
           updateScore (hit);
           // Start the alien explosion countdown
-          explosionCountdown = COUNTDOWN_EXPLOSION;
+          game.explosionCountdown = COUNTDOWN_EXPLOSION;
         } else {   
           // Check for collisions with defences
           if (defenceCollisionDetect (base.getLaserX (), base.getLaserY (), aliens.getBottom (), POWER_LASER)) {
@@ -236,20 +337,17 @@ void gameLoop() {
             sounds.laserStop ();
           } else {
             // Check for collisions with the mystery ship (if there is one)
-            hit = mystery.collisionDetect (screen, base.getLaserX (), base.getLaserY ());
+            hit = mystery.collisionDetect (base.getLaserX (), base.getLaserY ());
             if (hit) {
               // Wooo!
               // Remove the laser shot
               base.destroyLaser ();
               // Start the mystery killed sound
-              soundCountdown = sounds.mysteryKilled (soundCountdown);         
+              sounds.mysteryKilled ();
               // Add the mystery value to the score
               updateScore (hit);
               // Set the countdown to remove the mystery score
-              mysteryHitCountdown = COUNTDOWN_MYSTERY_HIT;
-            } else {
-              // Didn't hit anything, so draw it
-              base.drawLaser (screen);
+              game.mysteryHitCountdown = COUNTDOWN_MYSTERY_HIT;
             }
           }
         }
@@ -259,40 +357,53 @@ void gameLoop() {
       }
     }
     // Set the countdown
-    laserMoveCountdown = COUNTDOWN_LASER_MOVE;
+    game.laserMoveCountdown = COUNTDOWN_LASER_MOVE;
   }
 
   // Move bombs if there are any and count them as we go
-  if (bombMoveCountdown <= 0) {
+  if (game.bombMoveCountdown <= 0) {
     // If any bombs moved, update the screen
     if (moveAndCreateBombs ()) screenUpdateRequired = true;
-    bombMoveCountdown = COUNTDOWN_BOMB_MOVE;
+    game.bombMoveCountdown = COUNTDOWN_BOMB_MOVE;
   }
 
   // Create a mystery? (if the aliens are low enough and there are sufficient aliens remaining)
-  if ((aliens.getTop () > 11) && mystery.canCreateNew () && (random (MYSTERY_PROBABILITY) == 0) && aliens.getAlienCount () > 7) {
-    mystery.init (screen);
-    soundCountdown = sounds.mysteryFlyby (soundCountdown);
+  // Rather than rolling the dice on every pass of the loop, the time until the
+  // ship appears is picked once, when it becomes allowed. If it stops being
+  // allowed, the countdown is abandoned and picked again next time.
+  // There's no mystery ship in the demo.
+  if (mode == MODE_GAME && (aliens.getTop () > 11) && mystery.canCreateNew () && aliens.getAlienCount () > 7) {
+    if (!game.mysteryArmed) {
+      game.mysteryCreateCountdown = gameRandom.interval (MYSTERY_MEAN_INTERVAL);
+      game.mysteryArmed = true;
+    } else if (game.mysteryCreateCountdown <= 0) {
+      mystery.init ();
+      sounds.mysteryFlyby ();
+      screenUpdateRequired = true;
+      game.mysteryArmed = false;
+    }
+  } else {
+    game.mysteryArmed = false;
   }
   
   // Check for end of level delay
-  if (interLevelCountdown <= 0) {
+  if (game.interLevelCountdown <= 0) {
     // Next level
-    level ++;
+    game.level ++;
     // Initialise
     startLevel ();
     // Reset the countdown, ready for next time
-    interLevelCountdown = COUNTDOWN_INTER_LEVEL;
+    game.interLevelCountdown = COUNTDOWN_INTER_LEVEL;
   }
 
   // If the base is dead and the coundown has reached zero
-  if (baseDeadCountdown <= 0) {
+  if (game.baseDeadCountdown <= 0) {
     // If a mystery ship exists, wait for it to complete its flyby
     if (mystery.exists ()) {
       // Restart the flyby sound if the explosion sound is still playing
       if (sounds.soundPlaying () == SOUND_BASE_EXPLODE) {
         sounds.soundStop ();
-        soundCountdown = sounds.mysteryFlyby (soundCountdown);
+        sounds.mysteryFlyby ();
       }
     // If there's no mystery ship
     } else {
@@ -300,61 +411,169 @@ void gameLoop() {
       if (sounds.soundPlaying ()) {
         // Stop it and set the countdown again
         sounds.soundStop ();
-        baseDeadCountdown = COUNTDOWN_BASE_DEAD;
+        game.baseDeadCountdown = COUNTDOWN_BASE_DEAD;
       // The sound has been previously switched off, so now we can move on
       } else {
         // Reduce the life count
-        lives --;
-        if (lives == 0) {
+        game.lives --;
+        if (game.lives == 0) {
           // End of game  - write message
-          gameOver ();
-          return;
+          playOver ();
+          return (false);
         }
-        // Update the lives on screen
-        updateLives ();
-        // Remove the base debris from the screen
-        base.clearBase (screen);
-        // Create a new one
+        // Replace the base debris with a new one
         base.init ();
-        // Put it on the screen
-        base.drawBase (screen);
         // Reset the countdown ready for next time
-        baseDeadCountdown = COUNTDOWN_BASE_DEAD;
+        game.baseDeadCountdown = COUNTDOWN_BASE_DEAD;
         screenUpdateRequired = true;
       }
     }
   }
-  
-  // Update screen if required
-  if (screenUpdateRequired) {
-    screen.update ();
-    screenUpdateRequired = false;
+  return (true);
+}
+
+/*
+ * Move the game's clock on
+ */
+void gameAdvance (unsigned long timeTaken) {
+  GameState &game = modeState.game;
+  // Adjust all countdowns
+  if (aliens.getAlienCount ()) game.alienStepCountdown -= timeTaken;
+  game.baseMoveCountdown -= timeTaken;
+  game.bombMoveCountdown -= timeTaken;
+  if (base.getLaserY ()) game.laserMoveCountdown -= timeTaken;
+  if (aliens.explosionPresent ()) game.explosionCountdown -= timeTaken;
+  if (aliens.getAlienCount () == 0) game.interLevelCountdown -= timeTaken;
+  if (base.isDead ()) game.baseDeadCountdown -= timeTaken;
+  if (mystery.exists ()) game.mysteryMoveCountdown -= timeTaken;
+  if (mystery.wasHit ()) game.mysteryHitCountdown -= timeTaken;
+  if (game.mysteryArmed) game.mysteryCreateCountdown -= timeTaken;
+}
+
+/*
+ * How long until the next countdown runs out (of those gameAdvance counts down)
+ */
+unsigned long gameTimeToNext () {
+  GameState &game = modeState.game;
+  long next = min (game.baseMoveCountdown, game.bombMoveCountdown);
+  if (aliens.getAlienCount ()) next = min (next, game.alienStepCountdown);
+  if (base.getLaserY ()) next = min (next, game.laserMoveCountdown);
+  if (aliens.explosionPresent ()) next = min (next, game.explosionCountdown);
+  if (aliens.getAlienCount () == 0) next = min (next, game.interLevelCountdown);
+  if (base.isDead ()) next = min (next, game.baseDeadCountdown);
+  if (mystery.exists ()) next = min (next, game.mysteryMoveCountdown);
+  if (mystery.wasHit ()) next = min (next, game.mysteryHitCountdown);
+  if (game.mysteryArmed) next = min (next, game.mysteryCreateCountdown);
+  // The demo's script has its own
+  if (mode == MODE_DEMO_PLAY) next = demoTimeToNext (next);
+  return (next > 0 ? next : 1);
+}
+
+/*
+ * Bring the game screen up to date with the game
+ * Everything that has changed is rubbed out where it was drawn, then drawn
+ * where it is now (so nothing rubs out anything else). Everything else is
+ * left alone, so only the changes get sent to the display.
+ */
+void drawGame () {
+  GameState &game = modeState.game;
+  // The score and lives (the demo doesn't have them)
+  if (mode == MODE_GAME) {
+    if (score != drawnScore) {
+      screen.clearRect (24, 0, 24, 5);
+      screen.setCursor (24, 0);
+      screen.writeScore (score);
+      drawnScore = score;
+    }
+    if (game.lives != drawnLives) {
+      drawLives ();
+      drawnLives = game.lives;
+    }
+  }
+  // Rub out everything that's changed
+#ifdef SSD1306_STRIP
+  aliens.erase (screen);
+#else
+  boolean stepped = aliens.erase (screen);
+#endif
+  mystery.erase (screen);
+  base.erase (screen);
+  for (uint8_t i = 0; i < MAX_BOMBS; i ++) {
+    bombs[i].erase (screen);
+  }
+  // Damaged defences are drawn from scratch
+#ifdef SSD1306_STRIP
+  for (uint8_t i = 0; i < 4; i ++) {
+    defence[i].show (screen);
+  }
+#else
+  boolean redrawn = false;
+  for (uint8_t i = 0; i < 4; i ++) {
+    if (defence[i].show (screen)) redrawn = true;
+  }
+  // Clearing the alien grid or a defence in the buffer also rubs out anything
+  // in front of it that hasn't moved (like a bomb just dropped), so that
+  // needs drawing again too
+  if (stepped || redrawn) {
+    if (redrawn && aliens.getBottom () > DEFENCE_TOP) aliens.offScreen ();
+    base.offScreen ();
+    for (uint8_t i = 0; i < MAX_BOMBS; i ++) {
+      bombs[i].offScreen ();
+    }
   }
+#endif
+  // Draw everything where it is now
+  aliens.show (screen);
+  mystery.show (screen);
+  base.show (screen);
+  for (uint8_t i = 0; i < MAX_BOMBS; i ++) {
+    bombs[i].show (screen);
+  }
+}
 
-  // Update sounds
-  if (soundCountdown <= 0) {
-    soundCountdown = sounds.countdownComplete ();
+/*
+ * Draw the game screen from scratch
+ */
+void redrawGame () {
+  screen.clear ();
+  screen.setRenderer (renderGame);
+  // The demo doesn't have the score and lives
+  if (mode == MODE_GAME) {
+    screen.write (F("SCORE "));
+    screen.setCursor (74, 0);
+    screen.write (F("LIVES"));
   }
-  
-  // Calcualate the time taken again (including screen update time)
-  unsigned long timeTaken = millis() - timeNow;
-  // If the the iteration took no time, then put in a 1 millisecond delay
-  if (timeTaken == 0) {
-    delay (1);
-    timeTaken = 1;
+  // Nothing is on the screen
+  drawnScore = 0xFFFF;
+  drawnLives = 0xFF;
+  aliens.offScreen ();
+  mystery.offScreen ();
+  base.offScreen ();
+  for (uint8_t i = 0; i < MAX_BOMBS; i ++) {
+    bombs[i].offScreen ();
   }
-  
-  // Adjust all countdowns
-  if (aliens.getAlienCount ()) alienStepCountdown -= timeTaken;
-  baseMoveCountdown -= timeTaken;
-  bombMoveCountdown -= timeTaken;
-  if (base.getLaserY ()) laserMoveCountdown -= timeTaken;
-  if (aliens.explosionPresent ()) explosionCountdown -= timeTaken;
-  if (aliens.getAlienCount () == 0) interLevelCountdown -= timeTaken;
-  if (base.isDead ()) baseDeadCountdown -= timeTaken;
-  if (mystery.exists ()) mysteryMoveCountdown -= timeTaken;
-  if (mystery.wasHit ()) mysteryHitCountdown -= timeTaken;
-  if (sounds.soundPlaying ()) soundCountdown -= timeTaken;
+  for (uint8_t i = 0; i < 4; i ++) {
+    defence[i].offScreen ();
+  }
+  drawGame ();
+}
+
+/*
+ * Collect the button events since the last time round the loop
+ * Returns the buttons held down, plus any that were pressed and let go in
+ * the meantime, so that a quick tap isn't missed.
+ */
+uint8_t readButtons () {
+  InputEvent event;
+  uint8_t pressed = 0;
+  input.poll ();
+  while (input.getEvent (event)) {
+    if (event.pressed) {
+      pressed |= event.button;
+      LATENCY_EDGE (event.button == BUTTON_FIRE ? LATENCY_FIRE : LATENCY_MOVE, event.time);
+    }
+  }
+  return (pressed | input.held ());
 }
 
 /*
@@ -370,28 +589,27 @@ uint8_t findUnusedBomb () {
 }
 
 /*
- * Add the hit to the score, check for a bonus life and update the screen
+ * Add the hit to the score and check for a bonus life
  */
 void updateScore (uint16_t hit) {
+  GameState &game = modeState.game;
+  // The demo doesn't keep score
+  if (mode != MODE_GAME) return;
   // Check for a bonus base
   if (score < EXTRA_LIFE && (score + hit) >= EXTRA_LIFE) {
-    lives ++;
-    updateLives ();
+    game.lives ++;
   }
   // Add the hit value to the score
   score += hit;
-  // Update the screen
-  screen.clearRect (24, 0, 24, 5);
-  screen.setCursor (24, 0);
-  screen.writeScore (score);
 }
 
 /*
- * Udate the number of lives on the screen
+ * Draw the number of lives on the screen
  */
-void updateLives () {
+void drawLives () {
+  GameState &game = modeState.game;
   screen.clearRect (98, 0, 30, 5);
-  for (int i = 1; i < lives; i ++) {
+  for (int i = 1; i < game.lives; i ++) {
     screen.drawBitmap (BM_BASE, 88 + (i * 10), 0);
   }
 }
@@ -400,38 +618,42 @@ void updateLives () {
  * Initialise the necessary variables to start the game
  */
 void gameStart () {
+  enterMode (MODE_GAME);
+  sounds.mute (false);
+  // The moment the player pressed fire is as good a seed as any
+  gameRandom.seed (Clock::micros ());
   score = 0;
-  lives = 3;
-  level = 1;
+  startPlay (3);
+}
+
+/*
+ * Set up the first level, for the game or the demo
+ */
+void startPlay (uint8_t lives) {
+  GameState &game = modeState.game;
+  game.lives = lives;
+  game.level = 1;
   base.init ();
   startLevel ();
-  interLevelCountdown = COUNTDOWN_INTER_LEVEL;
-  mysteryMoveCountdown = COUNTDOWN_MYSTERY_MOVE;
-  explosionCountdown = COUNTDOWN_EXPLOSION; 
-  mysteryHitCountdown = COUNTDOWN_MYSTERY_HIT;
-  baseDeadCountdown = COUNTDOWN_BASE_DEAD;  
-  alienStepCountdown = 0;
-  laserMoveCountdown = 0;
-  bombMoveCountdown = 0;
-  soundCountdown = 30000;
-  fireButtonReleased = false;
+  // The other countdowns start at zero
+  game.interLevelCountdown = COUNTDOWN_INTER_LEVEL;
+  game.mysteryMoveCountdown = COUNTDOWN_MYSTERY_MOVE;
+  game.explosionCountdown = COUNTDOWN_EXPLOSION;
+  game.mysteryHitCountdown = COUNTDOWN_MYSTERY_HIT;
+  game.baseDeadCountdown = COUNTDOWN_BASE_DEAD;
+  game.baseMoveCountdown = COUNTDOWN_BASE_MOVE;
+  screenUpdateRequired = true;
 }
 
 /*
- * Set up the screen ready for the next level
+ * Set up the next level
  */
 void startLevel () {
-  screen.clear ();
-  screen.write (F("SCORE "));
-  screen.writeScore (score);
-  screen.setCursor (74, 0);
-  screen.write (F("LIVES"));
-  updateLives ();
   // Create the alien grid (starting position will vary according to level)
   aliens.init (calcAlienStartY());
   // Create the defences
   for (uint8_t i = 0; i < 4; i ++) {
-    defence[i].init (screen, 15 + (i * 28));
+    defence[i].init (15 + (i * 28));
   }
   // Make sure all the bombs are initialised
   for (int i = 0; i < MAX_BOMBS; i ++) {
@@ -441,8 +663,33 @@ void startLevel () {
   base.destroyLaser ();
   // ...and the mystery ship
   mystery.destroy ();
-  // Put the base on the screen
+  // Put it all on the screen
+  if (rendering) redrawGame ();
+}
+
+/*
+ * Draw everything in the game (only called in strip mode, when a page of the
+ * screen needs drawing - see SSD1306.cpp)
+ */
+void renderGame () {
+  for (uint8_t i = 0; i < 4; i ++) {
+    defence[i].draw (screen);
+  }
+  aliens.draw (screen);
+  mystery.draw (screen);
   base.drawBase (screen);
+  base.drawLaser (screen);
+  for (uint8_t i = 0; i < MAX_BOMBS; i ++) {
+    bombs[i].draw (screen);
+  }
+}
+
+/*
+ * The same, but leaving room for the game over message
+ */
+void renderGameOver () {
+  renderGame ();
+  screen.clearRect (38, 22, 52, 19);
 }
 
 /*
@@ -453,7 +700,7 @@ boolean defenceCollisionDetect (uint8_t x, uint8_t y, uint8_t alien_y, uint8_t p
   // Go through each defence
   for (int i = 0; i < 4; i ++) {
     // and check for a collision
-    if (defence[i].collisionDetect (screen, x, y, alien_y, power)) {
+    if (defence[i].collisionDetect (x, y, alien_y, power)) {
       return (true);
     }
   }
@@ -464,7 +711,8 @@ boolean defenceCollisionDetect (uint8_t x, uint8_t y, uint8_t alien_y, uint8_t p
  * Calculate the alien grid start position, based on level
  */
 uint8_t calcAlienStartY () {
-  uint8_t y = (level * 4) + 2;
+  GameState &game = modeState.game;
+  uint8_t y = (game.level * 4) + 2;
   if (y > 23) y = 23;
   return (y);
 }
@@ -473,6 +721,8 @@ uint8_t calcAlienStartY () {
  * If there are any bombs in transit move them and check for collisions
  */
 boolean moveAndCreateBombs () {
+  TRACE_SCOPE (TRACE_BOMBS);
+  GameState &game = modeState.game;
   // The count of currenly active bombs (accumulated as we go)
   uint8_t bombCount = 0;
   // screen update flag
@@ -482,7 +732,7 @@ boolean moveAndCreateBombs () {
   // Go through the bomb array
   for (int i = 0; i < MAX_BOMBS; i ++) {
     // If the bomb exists and moved
-    if (bombs[i].move (screen)) {
+    if (bombs[i].move ()) {
       update = true;
       // If the bombs still exists (if could have hit the bottom of the screen)
       if (bombs[i].exists ()) {
@@ -491,32 +741,30 @@ boolean moveAndCreateBombs () {
           bombs[i].destroy ();
         } else {
           // Check for collisions with the base
-          if (base.collisionDetect (screen, bombs[i].getX (), bombs[i].getY ())) {
+          if (base.collisionDetect (bombs[i].getX (), bombs[i].getY ())) {
             // Oops! Base hit, set the countdown for the explosion
-            baseDeadCountdown = COUNTDOWN_BASE_DEAD;
+            game.baseDeadCountdown = COUNTDOWN_BASE_DEAD;
             // And start the explosion sound
             sounds.baseExplode ();
             // Remove the bomb
             bombs[i].destroy ();
           } else {
-            // Didn't hit anything, so just draw it
-            bombs[i].draw (screen);
-            // Count it
+            // Didn't hit anything, so count it
             bombCount ++;
           }
         }
       }
     }
   }
-  // If the base is dead, no new bombs, so escape here
-  if (base.isDead ()) return (update);
+  // If the base is dead, no new bombs, so escape here (the demo drops its bombs when its script says)
+  if (base.isDead () || mode != MODE_GAME) return (update);
   // Calculate what the current maximum number of bombs is
-  uint8_t bombMax = level > 1 ? 1 : 0;
+  uint8_t bombMax = game.level > 1 ? 1 : 0;
   if (aliens.getTop () > BOMB_POINT1) {
     bombMax ++;
-    if (level > 1 && aliens.getTop () > BOMB_POINT2) {
+    if (game.level > 1 && aliens.getTop () > BOMB_POINT2) {
       bombMax ++;
-      if (level > 2) {
+      if (game.level > 2) {
         bombMax ++;
       }
     }
@@ -524,7 +772,7 @@ boolean moveAndCreateBombs () {
   // Can we release one?
   if (bombCount < bombMax) {
     // Probability is related to how close the aliens are to the bottom and the number of remaining bombs available
-    if (random (0, ((((SSD1306_LCDHEIGHT - aliens.getBottom ()) * BOMB_FACTOR) * (bombCount + 1)) / bombMax)) == 0) {
+    if (gameRandom.below ((((SSD1306_LCDHEIGHT - aliens.getBottom ()) * BOMB_FACTOR) * (bombCount + 1)) / bombMax) == 0) {
       // Select a random alien column
       uint8_t col = aliens.getRandomColumn ();
       // Get the y value of that alien
@@ -532,7 +780,7 @@ boolean moveAndCreateBombs () {
       // If there's an alien in this column
       if (bomb_y) {
         // Create a new bomb
-        bombs[findUnusedBomb ()].create (screen, aliens.getColX (col), bomb_y);
+        bombs[findUnusedBomb ()].create (aliens.getColX (col), bomb_y);
         update = true;
       }
     }
@@ -540,29 +788,58 @@ boolean moveAndCreateBombs () {
   return (update);
 }
 
+/*
+ * The last base has gone, or the aliens have landed
+ */
+void playOver () {
+  if (mode == MODE_GAME) {
+    gameOver ();
+  } else {
+    demoPlayOver ();
+  }
+}
+
 /*
  * Game over
  * Clear an area in the middle of the screen and write GAME OVER
  * Stop any sounds
- * Wait for 5 seconds
- * Tidy up
- * Trigger the demo start
+ * Leave the message up for 5 seconds (see gameOverLoop)
  */
 void gameOver () {
+  // Show how it ended
+  drawGame ();
+  enterMode (MODE_GAME_OVER);
+  screen.setRenderer (renderGameOver);
   screen.clearRect (38, 22, 52, 19);
   screen.setCursor (45, 29);
   screen.write (F("GAME OVER"));
   screen.update ();
   sounds.soundStop ();
-  delay (5000);
+  LATENCY_REPORT ();
+  modeState.gameOver.countdown = 5000;
+}
+
+/*
+ * Wait for the game over message to time out
+ * Tidy up
+ * Go on to the high score entry, if the score made it into the table,
+ * otherwise start the demo
+ */
+void gameOverLoop () {
+  Clock::delay (1);
+  if (-- modeState.gameOver.countdown > 0) return;
   // Get rid of unwanted potential remnants
   mystery.destroy ();
   base.destroyLaser ();
   for (uint8_t i = 0; i < MAX_BOMBS; i ++) {
     bombs[i].destroy ();
   }
-  demoStart ();
-  fireButtonReleased = true; // This is re-used for checking the score and performing the high score table stuff
+  if (highScores.isNewHighScore (score)) {
+    initHighScoreGrid ();
+  } else {
+    score = 0;
+    demoStart ();
+  }
 }
 
 /*
@@ -589,39 +866,31 @@ void drawTitle () {
  * DEMO
  * 
  * All code below this point relates to the demo mode.
- * There is a lot of variable re-use in order to save valuable RAM
- * These variables have been given aliases by the #defines following this
- * comment.
- * 
- * Yes, the code is a bit clunky, but it's all done to save RAM
+ * Its variables live in modeState.demo (see modes.h), sharing their RAM
+ * with the game's. When the demo plays the game, it uses the game's
+ * variables and the game's own tick (see demoPlayLoop). Pressing left or
+ * right while it plays skips to the end of the game.
  * 
  *************************************************************************/
-#define demoStep lives // Reusing the lives variable
-#define demoStepCountdown interLevelCountdown // Reusing interLevelCountdown variable
-#define slowTypeOffset alienStepCountdown // Reusing alienStepCountdown variable
-#define baseDirection soundCountdown // Reusing soundCountdown variable
-#define animationStepCountdown mysteryMoveCountdown // Reusing mysteryMoveCountdown variable
-#define animationStep mysteryHitCountdown // Reusing mysteryHitCountdown variable
-#define alienX alienStepCountdown // Reusing alienStepCountdown variable
 
 /*
  * Trigger the demo start
  */
 void demoStart () {
-  demoStep = 0; // Set the beginning of the demo sequence
-  level = 0; // Setting the level to 0 indicates demo mode
-  demoStepCountdown = 0; // Set the coundown
+  enterMode (MODE_DEMO); // This also sets the beginning of the demo sequence, with no delay
+  input.flush (); // Forget any buttons pressed during the game over message
 }
 
 void demoLoop () {
+  DemoState &demo = modeState.demo;
   // If the fire button is pressed
-  if (!digitalRead (FIRE_PIN)) {
+  if (readButtons () & BUTTON_FIRE) {
     // Trigger the game to start
     gameStart ();
     return;
   }
-  if (demoStepCountdown <= 0) {
-    switch (demoStep) {
+  if (demo.stepCountdown <= 0) {
+    switch (demo.step) {
       case 0:
         // Draw the main title for 5 seconds and move on to the next step
         drawTitle ();
@@ -717,282 +986,16 @@ void demoLoop () {
         // Slow type "=10 POINTS"
         if (slowType (F("=10 POINTS"))) {
           // Finished, move on to the next step
-          nextStep (demoStep == 8 ? 5000 : 1000);
+          nextStep (demo.step == 8 ? 5000 : 1000);
         } else {
           // Update the screen and go round again
           screen.update ();
         }
         break;
       case 9:
-        // Game play animation
-        screen.clear ();
-        // Set up the alien grid
-        aliens.init (6);
-        // and the base
-        base.init ();
-        // Create defences
-        for (uint8_t i = 0; i < 4; i ++) {
-          defence[i].init (screen, 15 + (i * 28));
-        }
-        // Clear all the bombs
-        for (uint8_t i = 0; i < MAX_BOMBS; i ++) {
-          bombs[i].destroy ();
-        }
-        // and the laser
-        base.destroyLaser ();
-        // Draw the base
-        base.drawBase (screen);
-        // Update the screen
-        screen.update ();
-        // Set the base movement to stationary
-        baseDirection = 0;
-        // Set the animation step
-        animationStep = 0;
-        // Set up the countdown timers
-        alienStepCountdown = 200 + COUNTDOWN_ALIEN_STEP + COUNTDOWN_ALIEN_STEP;
-        bombMoveCountdown = COUNTDOWN_BOMB_MOVE;
-        animationStepCountdown = 50;
-        baseDeadCountdown = COUNTDOWN_BASE_DEAD;
-        // Move on the the next demo step
-        nextStep (100);
-        break;
-      case 10:
-        screenUpdateRequired = false;
-        // Animation steps
-        if (animationStepCountdown <= 0) {
-          animationStep ++;
-          animationStepCountdown = 50;
-          switch (animationStep) {
-            case 4:
-              // Base fires and starts moving right
-              base.fire (screen, false);
-              base.fire (screen, true);
-              baseDirection = 1; // Start moving base right
-              break;
-            case 19:
-              // Alien column 10 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (10), aliens.getColY (10), FAST_BOMB);
-              break;            
-            case 21:
-              // Base stops and fires
-              baseDirection = 0; // Stop base
-              base.fire (screen, false);
-              base.fire (screen, true);
-              break;
-            case 25:
-              // Alien column 3 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (3), aliens.getColY (3), SLOW_BOMB);
-              break;
-            case 26:
-              // Base fires
-              base.fire (screen, false);
-              base.fire (screen, true);
-              break;            
-            case 29:
-              // Alien column 0 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (0), aliens.getColY (0), SLOW_BOMB);
-              break;
-            case 30:
-              // Base fires and starts moving right
-              base.fire (screen, false);
-              base.fire (screen, true);
-              baseDirection = 1; // Start moving right
-              break;
-            case 35:
-              // Alien column 5 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (5), aliens.getColY (5), SLOW_BOMB);
-              // Base stops and fires
-              base.fire (screen, false);
-              base.fire (screen, true);
-              baseDirection = 0;
-              break;
-            case 41:
-              // Alien column 6 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (6), aliens.getColY (6), FAST_BOMB);
-              break;
-            case 45:
-              // Base fires and starts moving left
-              base.fire (screen, false);
-              base.fire (screen, true);
-              baseDirection = -1;
-              break;
-            case 48:
-              // Alien column 6 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (6), aliens.getColY (6), SLOW_BOMB);
-              break;
-            case 54:
-              // Base fires and starts to move right
-              base.fire (screen, false);
-              base.fire (screen, true);
-              baseDirection = 1;
-              // Alien column 6 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (6), aliens.getColY (7), FAST_BOMB);
-              break;
-            case 60:
-              // Alien column 3 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (3), aliens.getColY (3), SLOW_BOMB);
-              break;
-            case 66:
-              // Alien column 0 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (0), aliens.getColY (0), SLOW_BOMB);
-              break;
-            case 69:
-              // Alien column 2 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (2), aliens.getColY (2), FAST_BOMB);
-              // Base stops and fires
-              base.fire (screen, false);
-              base.fire (screen, true);
-              baseDirection = 0;
-              break;
-            case 73:
-              // Base fires and starts to move left
-              base.fire (screen, false);
-              base.fire (screen, true);
-              baseDirection = -1;
-              break;
-            case 78:
-              // Alien column 4 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (4), aliens.getColY (4), SLOW_BOMB);
-              // Base fires
-              base.fire (screen, false);
-              base.fire (screen, true);
-              break;
-            case 79:
-              // Base starts to move right
-              baseDirection = 1;
-              break;
-            case 82:
-              // Alien column 0 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (0), aliens.getColY (0), SLOW_BOMB);
-              break;
-            case 88:
-              // Alien column 0 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (0), aliens.getColY (0), FAST_BOMB);
-              // Base fires
-              base.fire (screen, false);
-              base.fire (screen, true);
-              break;
-            case 100:
-              // Base stops
-              baseDirection = 0;
-              break;
-            case 103:
-              // Alien column 0 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (0), aliens.getColY (0), FAST_BOMB);
-              break;
-            case 105:
-              // Base fires
-              base.fire (screen, false);
-              base.fire (screen, true);
-              break;
-            case 108:
-              // Alien column 9 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (9), aliens.getColY (9), SLOW_BOMB);
-              break;
-            case 112:
-              // Alien column 3 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (3), aliens.getColY (3), SLOW_BOMB);
-              // Base fires
-              base.fire (screen, false);
-              base.fire (screen, true);
-              break;
-            case 114:
-              // Alien column 10 drops a bomb
-              bombs[findUnusedBomb ()].create (screen, aliens.getColX (10), aliens.getColY (10), SLOW_BOMB);
-              break;     
-          }
-        }
-        // Remove explosion if present
-        if (explosionCountdown <= 0) {
-          aliens.clearExplosion ();
-          screenUpdateRequired = true;
-          // Stop this from repeating unnecessarily
-          explosionCountdown = COUNTDOWN_EXPLOSION;
-        }
-        // Alien step
-        if (alienStepCountdown <= 0) {
-          aliens.step (screen);
-          alienStepCountdown = 220 + COUNTDOWN_ALIEN_STEP + COUNTDOWN_ALIEN_STEP;
-          screenUpdateRequired = true;
-        }
-        // Move bombs
-        if (bombMoveCountdown <= 0) {
-          // Go through each bomb
-          for (uint8_t i = 0; i < MAX_BOMBS; i ++) {
-            // Move it it it's active
-            if (bombs[i].move (screen)) {
-              // Did it move?
-              screenUpdateRequired = true;
-              // If it still exists
-              if (bombs[i].exists ()) {
-                // Check for collisions with the defences
-                if (defenceCollisionDetect (bombs[i].getX (), bombs[i].getY (), aliens.getBottom (), bombs[i].getPower ())) {
-                  bombs[i].destroy ();
-                } else {
-                  // Check for collisions with the base
-                  if (base.collisionDetect (screen, bombs[i].getX (), bombs[i].getY ())) {
-                    baseDeadCountdown = COUNTDOWN_BASE_DEAD;
-                  } else {
-                    // No collisions, just draw it
-                    bombs[i].draw (screen);
-                  }
-                }
-              }
-            }
-          }
-          bombMoveCountdown = COUNTDOWN_BOMB_MOVE;
-        }
-        // Move the base if it's moving
-        if (baseMoveCountdown <= 0) {
-          if (base.moveBase (screen, baseDirection < 0, baseDirection > 0)) {
-            screenUpdateRequired = true;
-          }
-          baseMoveCountdown = COUNTDOWN_BASE_MOVE;
-        }
-        // Move the laser shot if there is one
-        if (laserMoveCountdown <= 0) {
-          if (base.moveLaser (screen)) {
-            // If there was one
-            screenUpdateRequired = true;
-            // If it's still there
-            if (base.getLaserY ()) {
-              // Check for collisions with aliens
-              if (aliens.collisionDetect (screen, base.getLaserX (), base.getLaserY ())) {
-                // Hit, ok, remove the laser shot
-                base.destroyLaser ();
-                // Start the alien explosion countdown
-                explosionCountdown = COUNTDOWN_EXPLOSION;
-              } else {
-                // Check for collisions with the defences
-                if (defenceCollisionDetect (base.getLaserX (), base.getLaserY (), aliens.getBottom (), POWER_LASER)) {
-                  // Hit, so remove the laser shot
-                  base.destroyLaser ();
-                } else {
-                  // Otherwise, draw the laser shot
-                  base.drawLaser (screen);
-                }
-              }
-            }
-          }
-          laserMoveCountdown = COUNTDOWN_LASER_MOVE;
-        }
-        // Update the screen if necessary
-        if (screenUpdateRequired) screen.update ();
-        // Process all of the countdowns
-        alienStepCountdown --;
-        baseMoveCountdown --;
-        bombMoveCountdown --;
-        animationStepCountdown --;
-        if (aliens.explosionPresent ()) explosionCountdown --;
-        if (base.getLaserY ()) laserMoveCountdown --;
-        if (base.isDead ()) baseDeadCountdown --;
-        // If the base is dead or the aliens have gotten too low, end the animation
-        if (baseDeadCountdown <= 0 || aliens.getBottom () < 35) {
-          nextStep (1000);
-        } else {
-          demoStepCountdown = 1;
-        }
-        break;
+        // Game play animation (the demo carries on from step 11 when it's over)
+        demoPlayStart ();
+        return;
       case 11:
         // Clear the screen and prepare for the slow type
         screen.clear ();
@@ -1012,9 +1015,9 @@ void demoLoop () {
         break;
       case 19:
         // Start the alien at the right side of the screen
-        alienX = 122;
+        demo.alienX = 122;
         // Draw it
-        screen.drawBitmap (BM_ALIEN30_1, alienX, 8);
+        screen.drawBitmap (BM_ALIEN30_1, demo.alienX, 8);
         // Update the screen
         screen.update ();
         // Move on to the next step
@@ -1023,60 +1026,60 @@ void demoLoop () {
       case 20:
         // Move the alien left
         // Erase it
-        screen.clearRect (alienX, 8, 5, 5);
+        screen.clearRect (demo.alienX, 8, 5, 5);
         // Move left
-        alienX --;
+        demo.alienX --;
         // Has it reached the inverted Y?
-        if (alienX <= 71) {
+        if (demo.alienX <= 71) {
           // Yes, move to the next step
           nextStep (30);
           break;
         }
         // Draw the alien
-        screen.drawBitmap (alienX % 2 == 1 ? BM_ALIEN30_2 : BM_ALIEN30_1, alienX, 8);
+        screen.drawBitmap (demo.alienX % 2 == 1 ? BM_ALIEN30_2 : BM_ALIEN30_1, demo.alienX, 8);
         screen.update ();
         // Go round again
-        demoStepCountdown = 30;
+        demo.stepCountdown = 30;
         break;
       case 21:
         // Move the alien and inverted Y right
         // Erase it
-        screen.clearRect (alienX - 3, 8, 8, 5);
+        screen.clearRect (demo.alienX - 3, 8, 8, 5);
         // Move right
-        alienX ++;
+        demo.alienX ++;
         // Has it reached the edge of the screen?
-        if (alienX >= 122) {
+        if (demo.alienX >= 122) {
           // Yes, move to the next step
           nextStep (500);
           screen.update ();
           break;
         }
         // Draw the inverted Y
-        screen.drawBitmap (BM_INVERTED_Y, alienX - 3, 8);
+        screen.drawBitmap (BM_INVERTED_Y, demo.alienX - 3, 8);
         // Draw the alien
-        screen.drawBitmap (alienX % 2 == 1 ? BM_ALIEN30_2 : BM_ALIEN30_1, alienX, 8);
+        screen.drawBitmap (demo.alienX % 2 == 1 ? BM_ALIEN30_2 : BM_ALIEN30_1, demo.alienX, 8);
         screen.update ();
-        demoStepCountdown = 30;
+        demo.stepCountdown = 30;
         // go round again
         break;
       case 22:
         // Move the alien and Y left
         // Did the Y reach its destination?
-        if (alienX <= 72) {
+        if (demo.alienX <= 72) {
           // Yes, so move to the next step
           nextStep (500);
           break;
         }
         // Erase the alien and Y
-        screen.clearRect (alienX - 3, 8, 8, 5);
+        screen.clearRect (demo.alienX - 3, 8, 8, 5);
         // Move left
-        alienX --;
+        demo.alienX --;
         // Draw the Y
-        screen.drawBitmap (BM_Y, alienX - 3, 8);
+        screen.drawBitmap (BM_Y, demo.alienX - 3, 8);
         // Draw the alien
-        screen.drawBitmap (alienX % 2 == 1 ? BM_ALIEN30_2 : BM_ALIEN30_1, alienX, 8);        
+        screen.drawBitmap (demo.alienX % 2 == 1 ? BM_ALIEN30_2 : BM_ALIEN30_1, demo.alienX, 8);        
         screen.update ();
-        demoStepCountdown = 30;
+        demo.stepCountdown = 30;
         // Go round again
         break;
       case 23:
@@ -1088,29 +1091,188 @@ void demoLoop () {
         break;
       case 24:
         // Show high score table (wait for 5 seconds if anything was displayed
-        demoStepCountdown = displayHighScores () ? 5000 : 1;
+        demo.stepCountdown = displayHighScores () ? 5000 : 1;
         // Restart the demo
-        demoStep = 0;
+        demo.step = 0;
+    }
+  }
+  Clock::delay (1);
+  demo.stepCountdown --;
+}
+
+/*
+ * The demo's game play script
+ * Each event comes a number of DEMO_TIME_STEPs after the one before (up to
+ * 15). It holds down the given buttons until the next event (although fire
+ * only gets pressed the once), and drops a bomb from a column of aliens.
+ * Packed into two bytes - the time and column, then the buttons and the bomb.
+ */
+#define DEMO_TIME_STEP 50 // Milliseconds
+#define DEMO_EVENT(time, buttons, bomb, column) { (uint8_t)(((time) << 4) | (column)), (uint8_t)((buttons) | ((bomb) << 3)) }
+#define DEMO_MOVE (BUTTON_LEFT | BUTTON_RIGHT)
+
+struct DemoEvent {
+  uint8_t timeColumn;
+  uint8_t action;
+};
+
+const DemoEvent demoScript[] PROGMEM = {
+  DEMO_EVENT (4, BUTTON_FIRE | BUTTON_RIGHT, NO_BOMB, 0),   // Base fires and starts moving right
+  DEMO_EVENT (15, BUTTON_RIGHT, FAST_BOMB, 10),             // Alien column 10 drops a bomb
+  DEMO_EVENT (2, BUTTON_FIRE, NO_BOMB, 0),                  // Base stops and fires
+  DEMO_EVENT (4, 0, SLOW_BOMB, 3),                          // Alien column 3 drops a bomb
+  DEMO_EVENT (1, BUTTON_FIRE, NO_BOMB, 0),                  // Base fires
+  DEMO_EVENT (3, 0, SLOW_BOMB, 0),                          // Alien column 0 drops a bomb
+  DEMO_EVENT (1, BUTTON_FIRE | BUTTON_RIGHT, NO_BOMB, 0),   // Base fires and starts moving right
+  DEMO_EVENT (5, BUTTON_FIRE, SLOW_BOMB, 5),                // Alien column 5 drops a bomb, base stops and fires
+  DEMO_EVENT (6, 0, FAST_BOMB, 6),                          // Alien column 6 drops a bomb
+  DEMO_EVENT (4, BUTTON_FIRE | BUTTON_LEFT, NO_BOMB, 0),    // Base fires and starts moving left
+  DEMO_EVENT (3, BUTTON_LEFT, SLOW_BOMB, 6),                // Alien column 6 drops a bomb
+  DEMO_EVENT (6, BUTTON_FIRE | BUTTON_RIGHT, FAST_BOMB, 6), // Base fires and starts to move right, alien column 6 drops a bomb
+  DEMO_EVENT (6, BUTTON_RIGHT, SLOW_BOMB, 3),               // Alien column 3 drops a bomb
+  DEMO_EVENT (6, BUTTON_RIGHT, SLOW_BOMB, 0),               // Alien column 0 drops a bomb
+  DEMO_EVENT (3, BUTTON_FIRE, FAST_BOMB, 2),                // Alien column 2 drops a bomb, base stops and fires
+  DEMO_EVENT (4, BUTTON_FIRE | BUTTON_LEFT, NO_BOMB, 0),    // Base fires and starts to move left
+  DEMO_EVENT (5, BUTTON_FIRE | BUTTON_LEFT, SLOW_BOMB, 4),  // Alien column 4 drops a bomb, base fires
+  DEMO_EVENT (1, BUTTON_RIGHT, NO_BOMB, 0),                 // Base starts to move right
+  DEMO_EVENT (3, BUTTON_RIGHT, SLOW_BOMB, 0),               // Alien column 0 drops a bomb
+  DEMO_EVENT (6, BUTTON_FIRE | BUTTON_RIGHT, FAST_BOMB, 0), // Alien column 0 drops a bomb, base fires
+  DEMO_EVENT (12, 0, NO_BOMB, 0),                           // Base stops
+  DEMO_EVENT (3, 0, FAST_BOMB, 0),                          // Alien column 0 drops a bomb
+  DEMO_EVENT (2, BUTTON_FIRE, NO_BOMB, 0),                  // Base fires
+  DEMO_EVENT (3, 0, SLOW_BOMB, 9),                          // Alien column 9 drops a bomb
+  DEMO_EVENT (4, BUTTON_FIRE, SLOW_BOMB, 3),                // Alien column 3 drops a bomb, base fires
+  DEMO_EVENT (2, 0, SLOW_BOMB, 10)                          // Alien column 10 drops a bomb
+};
+#define DEMO_EVENTS (sizeof (demoScript) / sizeof (DemoEvent))
+
+/*
+ * Start the demo playing the game
+ */
+void demoPlayStart () {
+  enterMode (MODE_DEMO_PLAY);
+  GameState &game = modeState.game;
+#ifndef SOUND_TIMELINE
+  // Play quietly (unless the sounds are being logged, see sound.h)
+  sounds.mute (true);
+#endif
+  // Just the one base, so the demo ends when it's hit
+  startPlay (1);
+  // Give the aliens a moment before they start marching
+  game.alienStepCountdown = 200 + COUNTDOWN_ALIEN_STEP + COUNTDOWN_ALIEN_STEP;
+  game.demoEventCountdown = (pgm_read_byte (&demoScript[0].timeColumn) >> 4) * DEMO_TIME_STEP;
+}
+
+/*
+ * The demo playing the game
+ */
+void demoPlayLoop () {
+  uint8_t pressed = readButtons ();
+  // If the fire button is pressed for real, start a game
+  if (pressed & BUTTON_FIRE) {
+    gameStart ();
+    return;
+  }
+  // Left or right skips to the end
+  if (pressed & DEMO_MOVE) {
+    demoPlaySkip ();
+    return;
+  }
+  demoPlayTick ();
+}
+
+/*
+ * Move the demo's game on, using the game's own tick
+ */
+void demoPlayTick () {
+  GameState &game = modeState.game;
+  uint8_t buttons = 0;
+  if (game.demoEvent) {
+    // Keep moving the way the last event said
+    buttons = pgm_read_byte (&demoScript[game.demoEvent - 1].action) & DEMO_MOVE;
+  }
+  if (game.demoEvent < DEMO_EVENTS && game.demoEventCountdown <= 0) {
+    uint8_t action = pgm_read_byte (&demoScript[game.demoEvent].action);
+    uint8_t column = pgm_read_byte (&demoScript[game.demoEvent].timeColumn) & 0x0F;
+    buttons = action & (DEMO_MOVE | BUTTON_FIRE);
+    if (action >> 3) demoBomb (column, action >> 3);
+    game.demoEvent ++;
+    if (game.demoEvent < DEMO_EVENTS) {
+      game.demoEventCountdown += (pgm_read_byte (&demoScript[game.demoEvent].timeColumn) >> 4) * DEMO_TIME_STEP;
+    }
+  }
+  unsigned long timeTaken = gameTick (buttons);
+  // Finished? (the base was destroyed)
+  if (mode != MODE_DEMO_PLAY) return;
+  game.demoEventCountdown -= timeTaken;
+  // End the animation once the bottom row of aliens has been shot
+  if (aliens.getBottom () < 35) demoPlayOver ();
+}
+
+/*
+ * Play the rest of the demo's game without drawing it, then show how it ended
+ */
+void demoPlaySkip () {
+  rendering = false;
+  while (mode == MODE_DEMO_PLAY) {
+    demoPlayTick ();
+  }
+  rendering = true;
+  // The demo has moved on, but everything is still where the game left it
+  redrawGame ();
+  screen.update ();
+}
+
+/*
+ * The time to the next thing that happens in the game (see gameTimeToNext),
+ * or to the next event in the script if that's sooner
+ */
+long demoTimeToNext (long next) {
+  GameState &game = modeState.game;
+  if (game.demoEvent < DEMO_EVENTS) return (min (next, game.demoEventCountdown));
+  return (next);
+}
+
+/*
+ * Drop a bomb from a column of aliens (if there are any left in it)
+ */
+void demoBomb (uint8_t column, uint8_t type) {
+  uint8_t y = aliens.getColY (column);
+  if (y == 0) return;
+  for (uint8_t i = 0; i < MAX_BOMBS; i ++) {
+    if (!bombs[i].exists ()) {
+      bombs[i].create (aliens.getColX (column), y, type);
+      screenUpdateRequired = true;
+      return;
     }
   }
-  delay (1);
-  demoStepCountdown --;
+}
+
+/*
+ * Go back to the rest of the demo, after a second
+ */
+void demoPlayOver () {
+  enterMode (MODE_DEMO);
+  modeState.demo.step = 11;
+  modeState.demo.stepCountdown = 1000;
 }
 
 /*
  * Move to the next step, setting the delay time
  */
 void nextStep (int delay) {
-  demoStep ++;
-  demoStepCountdown = delay;
+  DemoState &demo = modeState.demo;
+  demo.step ++;
+  demo.stepCountdown = delay;
 }
 
 /*
  * Set the cursor position and offset ready for slow type
  */
 void slowTypeInit (uint8_t x, uint8_t y) {
+  DemoState &demo = modeState.demo;
   // Set the offset to the beginning
-  slowTypeOffset = 0;
+  demo.slowTypeOffset = 0;
   // and the cursor position
   screen.setCursor (x, y); 
 }
@@ -1120,11 +1282,12 @@ void slowTypeInit (uint8_t x, uint8_t y) {
  * Put each character of the string on the screen individually
  */
 boolean slowType (const __FlashStringHelper* s) {
-  demoStepCountdown = 200;
-  uint8_t ch = pgm_read_byte((char *)s + slowTypeOffset);
+  DemoState &demo = modeState.demo;
+  demo.stepCountdown = 200;
+  uint8_t ch = pgm_read_byte((char *)s + demo.slowTypeOffset);
   if (ch) {
     screen.write (ch);
-    slowTypeOffset ++;
+    demo.slowTypeOffset ++;
     return (false);
   }
   return (true);
@@ -1139,12 +1302,6 @@ boolean slowType (const __FlashStringHelper* s) {
  * 
  *************************************************************************/
 
-#define HS_OFFSET 0 // Change this if you want to store the high score table somewhere else in EEPROM
-#define HS_START (HS_OFFSET + 2) // Room for the magic number
-#define HS_MAX 5 // Maximum number of entries
-#define HS_RECORD_SIZE 5 // Records consist of int (2 bytes) + three initials
-#define HS_NAME_OFFSET 2
-#define HS_END (HS_START + (HS_MAX * HS_RECORD_SIZE))
 #define HS_GRID_WIDTH 10
 #define HS_GRID_HEIGHT 3
 #define HS_GRID_X 24
@@ -1154,13 +1311,7 @@ boolean slowType (const __FlashStringHelper* s) {
 #define NAME_X_START 71
 #define NAME_Y 19
 
-#define namePtr alienStepCountdown // Reusing alienStepCountdown variable
-#define cursorX soundCountdown // Reusing soundCountdown variable
-#define cursorY mysteryMoveCountdown // Reusing mysteryMoveCountdown variable
-#define flashCountdown mysteryHitCountdown // Reusing mysteryHitCountdown variable
-#define buttonReleased explosionCountdown // Reusing explosionCountdown variable
-#define nameX baseMoveCountdown  // Reusing baseMoveCountdown variable
-#define flashOn laserMoveCountdown // reusing laserMoveCountdown variable
+// The high score entry's variables live in modeState.highScore (see modes.h)
 
 
 /*
@@ -1171,20 +1322,20 @@ boolean displayHighScores () {
   uint8_t displayPos = '1';
   uint8_t actualPos = '1';
   uint16_t currentHighScore = 0;
-  uint16_t address;
+  uint8_t entry;
   uint16_t currentScore;
   // Find the highest score
-  for (uint16_t i = HS_START; i < HS_END; i += HS_RECORD_SIZE) {
-    currentScore = readUint16_t (i);
+  for (uint8_t i = 0; i < HS_MAX; i ++) {
+    currentScore = highScores.getScore (i);
     if (currentScore > currentHighScore) {
       currentHighScore = currentScore;
-      address = i;
+      entry = i;
     }
   }
   if (currentHighScore == 0) return (false);
   screen.clear ();
   screen.setCursor (42, 7);
-  screen.write ("HIGH SCORES");
+  screen.write (F("HIGH SCORES"));
   for (uint8_t i = 16; i < 16 + (HS_MAX * 8); i += 8) {
     if (currentHighScore == 0) break;
     if (displayPos == actualPos) {
@@ -1192,41 +1343,42 @@ boolean displayHighScores () {
       screen.write (displayPos);
       switch (displayPos) {
         case '1':
-          screen.write ("ST");
+          screen.write (F("ST"));
           break;
         case '2':
-          screen.write ("ND");
+          screen.write (F("ND"));
           break;
         case '3':
-          screen.write ("RD");
+          screen.write (F("RD"));
           break;
         default:
-          screen.write ("TH");
+          screen.write (F("TH"));
       }
     }
     screen.setCursor (currentHighScore > 9999 ? 56 : 52, i);
     screen.writeScore (currentHighScore);
     screen.setCursor (96, i);
-    screen.write (EEPROM.read (address + 2));
-    screen.write (EEPROM.read (address + 3));
-    screen.write (EEPROM.read (address + 4));
-    address += HS_RECORD_SIZE;
-    while (address < HS_END) {
-      if (readUint16_t (address) == currentHighScore) {
+    const uint8_t *name = highScores.getName (entry);
+    screen.write (name[0]);
+    screen.write (name[1]);
+    screen.write (name[2]);
+    entry ++;
+    while (entry < HS_MAX) {
+      if (highScores.getScore (entry) == currentHighScore) {
         break;
       }
-      address += HS_RECORD_SIZE;
+      entry ++;
     }
     actualPos ++;
-    if (address >= HS_END) {
+    if (entry >= HS_MAX) {
       currentScore = 0;
       uint16_t tmpScore;
-      for (uint16_t j = HS_START; j < HS_END; j += HS_RECORD_SIZE) {
-        tmpScore = readUint16_t (j);
+      for (uint8_t j = 0; j < HS_MAX; j ++) {
+        tmpScore = highScores.getScore (j);
         if (tmpScore < currentHighScore) {
           if (tmpScore > currentScore) {
             currentScore = tmpScore;
-            address = j;
+            entry = j;
           }
         }
       }
@@ -1239,12 +1391,14 @@ boolean displayHighScores () {
 }
 
 void initHighScoreGrid () {
+  enterMode (MODE_HIGH_SCORE);
+  HighScoreState &entry = modeState.highScore;
   screen.clear ();
   screen.setCursor (32, 7);
-  screen.write ("HIGH SCORE ");
+  screen.write (F("HIGH SCORE "));
   screen.writeScore (score);
   screen.setCursor (48, NAME_Y);
-  screen.write ("NAME");
+  screen.write (F("NAME"));
   uint8_t x;
   uint8_t y = HS_GRID_Y + 2;
   uint8_t c;
@@ -1258,14 +1412,10 @@ void initHighScoreGrid () {
     }
     y += HS_GRID_STEP_Y;
   }
-  // Set some variables up
-  namePtr = 0;
-  cursorX = 0;
-  cursorY = 0;
-  flashCountdown = 0;
-  flashOn = false;
-  nameX = NAME_X_START;
-  buttonReleased = true;
+  // Set some variables up (the name and cursor start at zero)
+  entry.nameX = NAME_X_START;
+  entry.buttonReleased = true;
+  input.flush ();
   drawCursor ();
   screen.update ();
 }
@@ -1274,83 +1424,86 @@ void initHighScoreGrid () {
  * High score loop allows the player to type in their initials
  */
 void highScoreLoop () {
-  if (buttonReleased) {
-    if (!digitalRead (FIRE_PIN)) {
+  HighScoreState &entry = modeState.highScore;
+  uint8_t buttons = readButtons ();
+  if (entry.buttonReleased) {
+    if (buttons & BUTTON_FIRE) {
       // Character selected
-      highScoreName[namePtr] = pgm_read_byte (&highScoreCharMap[cursorY][cursorX]);
-      if (highScoreName[namePtr] == '<' && namePtr > 0) {
-        namePtr --;
+      entry.name[entry.namePtr] = pgm_read_byte (&highScoreCharMap[entry.cursorY][entry.cursorX]);
+      if (entry.name[entry.namePtr] == '<' && entry.namePtr > 0) {
+        entry.namePtr --;
       } else {
-        namePtr ++;
+        entry.namePtr ++;
       }
       screen.clearRect (NAME_X_START, NAME_Y, 24, 5);
       screen.setCursor (NAME_X_START, NAME_Y);
-      nameX = NAME_X_START;
-      for (uint8_t i = 0; i < namePtr; i ++) {
-        screen.write (highScoreName[i]);
-        nameX += screen.charWidth (highScoreName[i]);
+      entry.nameX = NAME_X_START;
+      for (uint8_t i = 0; i < entry.namePtr; i ++) {
+        screen.write (entry.name[i]);
+        entry.nameX += screen.charWidth (entry.name[i]);
       }
       screen.update ();
-      buttonReleased = false;
-    } else if (!digitalRead (LEFT_PIN)) {
+      entry.buttonReleased = false;
+    } else if (buttons & BUTTON_LEFT) {
       // Move cursor left
       removeCursor ();
-      cursorX --;
-      if (cursorX < 0) {
-        cursorX = HS_GRID_WIDTH - 1;
-        cursorY --;
-        if (cursorY < 0) {
-          cursorY = HS_GRID_HEIGHT - 1;
+      entry.cursorX --;
+      if (entry.cursorX < 0) {
+        entry.cursorX = HS_GRID_WIDTH - 1;
+        entry.cursorY --;
+        if (entry.cursorY < 0) {
+          entry.cursorY = HS_GRID_HEIGHT - 1;
         }
       }
       drawCursor ();
       screen.update ();
-      buttonReleased = false;
-    } else if (!digitalRead (RIGHT_PIN)) {
+      entry.buttonReleased = false;
+    } else if (buttons & BUTTON_RIGHT) {
       // Move cursor right
       removeCursor ();
-      cursorX ++;
-      if (cursorX >= HS_GRID_WIDTH) {
-        cursorX = 0;
-        cursorY ++;
-        if (cursorY >= HS_GRID_HEIGHT) {
-          cursorY = 0;
+      entry.cursorX ++;
+      if (entry.cursorX >= HS_GRID_WIDTH) {
+        entry.cursorX = 0;
+        entry.cursorY ++;
+        if (entry.cursorY >= HS_GRID_HEIGHT) {
+          entry.cursorY = 0;
         }
       }
       drawCursor ();
       screen.update ();
-      buttonReleased = false;
+      entry.buttonReleased = false;
     }
   } else {
     // Check all the buttons have been released
-    buttonReleased =digitalRead (FIRE_PIN) && digitalRead (LEFT_PIN) && digitalRead (RIGHT_PIN);
-    if (buttonReleased && namePtr > 2) {
-      addHighScore (score, highScoreName);
+    entry.buttonReleased = (buttons == 0);
+    if (entry.buttonReleased && entry.namePtr > 2) {
+      highScores.add (score, entry.name);
       score = 0;
       demoStart ();
-      delay (1000);
+      Clock::delay (1000);
       return;
     }
   }
-  if (flashCountdown <= 0 && namePtr < 3) {
-    if (flashOn) {
-      screen.clearRect (nameX, NAME_Y, 6, 5);
-      flashOn = false;
+  if (entry.flashCountdown <= 0 && entry.namePtr < 3) {
+    if (entry.flashOn) {
+      screen.clearRect (entry.nameX, NAME_Y, 6, 5);
+      entry.flashOn = false;
     } else {
-      screen.setCursor (nameX, NAME_Y);
-      screen.write (pgm_read_byte (&highScoreCharMap[cursorY][cursorX]));
-      flashOn = true;
+      screen.setCursor (entry.nameX, NAME_Y);
+      screen.write (pgm_read_byte (&highScoreCharMap[entry.cursorY][entry.cursorX]));
+      entry.flashOn = true;
     }
     screen.update ();
-    flashCountdown = 500;
+    entry.flashCountdown = 500;
   }
-  flashCountdown --;
-  delay (1); // We put a delay in here, to eliminiate key bounce
+  entry.flashCountdown --;
+  Clock::delay (1); // We put a delay in here, to pace the cursor flash (key bounce is dealt with by the input interrupt)
 }
 
 void drawCursor () {
-  uint8_t x = HS_GRID_X + (cursorX * HS_GRID_STEP_X);
-  uint8_t y = HS_GRID_Y + (cursorY * HS_GRID_STEP_Y);
+  HighScoreState &entry = modeState.highScore;
+  uint8_t x = HS_GRID_X + (entry.cursorX * HS_GRID_STEP_X);
+  uint8_t y = HS_GRID_Y + (entry.cursorY * HS_GRID_STEP_Y);
   screen.drawBitmap (BM_BOX_TOP, x, y - 3);
   screen.drawBitmap (BM_BOX_SIDE, x, y + 2);
   screen.drawBitmap (BM_BOX_SIDE, x + 8, y + 2);
@@ -1358,74 +1511,180 @@ void drawCursor () {
 }
 
 void removeCursor () {
-  uint8_t x = HS_GRID_X + (cursorX * HS_GRID_STEP_X);
-  uint8_t y = HS_GRID_Y + (cursorY * HS_GRID_STEP_Y);
+  HighScoreState &entry = modeState.highScore;
+  uint8_t x = HS_GRID_X + (entry.cursorX * HS_GRID_STEP_X);
+  uint8_t y = HS_GRID_Y + (entry.cursorY * HS_GRID_STEP_Y);
   screen.clearRect (x, y, 9, 2);
   screen.clearRect (x, y + 2, 1, 5);
   screen.clearRect (x + 8, y + 2, 1, 5);
   screen.clearRect (x, y + 7, 9, 2);
 }
 
+#ifdef SCENARIO_BENCH
+/**************************************************************************
+ * 
+ * WORST CASE SCENARIOS
+ * 
+ * Each scenario starts a fresh game, sets up something busy, then runs the
+ * game for SCENARIO_FRAMES frames, forcing whatever the scenario is about
+ * to happen every frame rather than waiting for its countdown. The frames
+ * go through the game's own gameStep () and drawGame (), so it's the real
+ * code being measured (see scenario.h).
+ * 
+ *************************************************************************/
+
+#define SCENARIO_MARCH 0      // The full grid of 55 aliens stepping
+#define SCENARIO_BOMBS 1      // Four bombs wearing away the defences
+#define SCENARIO_MYSTERY 2    // The mystery ship flying by, then shot and its score shown
+#define SCENARIO_LEVEL 3      // Starting a new level, which redraws the whole screen
+#define SCENARIO_ALL 4        // The aliens stepping, bombs, the laser, explosions and the mystery ship at once
+#define SCENARIOS 5
+
 /*
- * Check if the high score table exists and if not, create it
+ * Run all the scenarios and print the results, then leave things ready for
+ * the demo
  */
-void highScoreInit (boolean reset) {
-  // Read the magic from the EEPROM
-  if (reset || EEPROM.read (HS_OFFSET) != 'S' || EEPROM.read (HS_OFFSET + 1) != 'I') {
-    // No magic, so let's initialise the high score table
-    for (uint8_t i = 0; i < HS_MAX * HS_RECORD_SIZE; i ++) {
-      EEPROM.update (HS_START + i, 0);
-    }
-    EEPROM.update (HS_OFFSET, 'S');
-    EEPROM.update (HS_OFFSET + 1, 'I');
+void scenarioRunAll () {
+  for (uint8_t i = 0; i < SCENARIOS; i ++) {
+    scenarioRun (i);
+  }
+  for (uint8_t i = 0; i < MAX_BOMBS; i ++) {
+    bombs[i].destroy ();
   }
+  mystery.destroy ();
+  base.destroyLaser ();
+  score = 0;
+  sounds.mute (false);
+  screen.clear ();
 }
 
-/*
- * Check if the score is a new high score
- */
-boolean isNewHighScore (uint16_t score) {
-  for (uint16_t i = 0; i < HS_MAX * HS_RECORD_SIZE; i ++) {
-    if (score > readUint16_t (i)) {
-      return (true);
+void scenarioRun (uint8_t which) {
+  GameState &game = modeState.game;
+  // A fresh game, which plays the same way every time
+  enterMode (MODE_GAME);
+  sounds.mute (true);
+  gameRandom.seed (SCENARIO_SEED);
+  score = 0;
+  startPlay (3);
+  // Drop the aliens down to where the bombs reach the defences quickly
+  if (which == SCENARIO_BOMBS || which == SCENARIO_ALL) {
+    game.level = 5;
+    startLevel ();
+  }
+  if (which == SCENARIO_MYSTERY || which == SCENARIO_ALL) {
+    mystery.init ();
+  }
+  // Get it all on the screen before measuring
+  drawGame ();
+  screen.update ();
+  screenUpdateRequired = false;
+  scenario.start ();
+  for (uint8_t frame = 0; frame < SCENARIO_FRAMES; frame ++) {
+    uint8_t buttons = scenarioForce (which, frame);
+    scenario.frameStart ();
+    boolean playing = gameStep (buttons);
+    if (playing && screenUpdateRequired) {
+      drawGame ();
+      screen.update ();
+      screenUpdateRequired = false;
     }
+    scenario.frameEnd ();
+    // The aliens landed, or the base ran out of lives
+    if (!playing) break;
+  }
+  switch (which) {
+    case SCENARIO_MARCH:
+      scenario.report (F("march"));
+      break;
+    case SCENARIO_BOMBS:
+      scenario.report (F("bombs"));
+      break;
+    case SCENARIO_MYSTERY:
+      scenario.report (F("mystery"));
+      break;
+    case SCENARIO_LEVEL:
+      scenario.report (F("level"));
+      break;
+    default:
+      scenario.report (F("all"));
   }
-  return (false);
 }
 
 /*
- * Add a new score to the high score table
+ * Make whatever the scenario is about happen in the next frame
+ * Returns the buttons to press
  */
-void addHighScore (uint16_t score, char *name) {
-  uint16_t address = findLowestScore ();
-  if (address) {
-    EEPROM.update (address ++, score >> 8);
-    EEPROM.update (address ++, score);
-    EEPROM.update (address ++, name[0]);
-    EEPROM.update (address ++, name[1]);
-    EEPROM.update (address ++, name[2]);
+uint8_t scenarioForce (uint8_t which, uint8_t frame) {
+  GameState &game = modeState.game;
+  uint8_t buttons = 0;
+  switch (which) {
+    case SCENARIO_MARCH:
+      game.alienStepCountdown = 0;
+      break;
+    case SCENARIO_BOMBS:
+      scenarioBombs (frame);
+      break;
+    case SCENARIO_MYSTERY:
+      scenarioMystery (frame);
+      break;
+    case SCENARIO_LEVEL:
+      game.interLevelCountdown = 0;
+      break;
+    default:
+      game.alienStepCountdown = 0;
+      scenarioBombs (frame);
+      scenarioMystery (frame);
+      // Keep the laser going
+      game.laserMoveCountdown = 0;
+      if (frame & 1) buttons = BUTTON_FIRE;
+      // Shoot an alien every so often, and clear the explosion away halfway between
+      if (frame % 8 == 0) {
+        uint8_t col = aliens.getRandomColumn ();
+        uint16_t hit = aliens.collisionDetect (aliens.getColX (col), aliens.getColY (col) - 1);
+        if (hit) {
+          updateScore (hit);
+          game.explosionCountdown = COUNTDOWN_EXPLOSION;
+        }
+      } else if (frame % 8 == 4) {
+        game.explosionCountdown = 0;
+      }
   }
+  return (buttons);
 }
 
 /*
- * Find the (first) lowest score in the table and return its address
+ * Keep all four bombs falling onto the defences, moving every frame
  */
-uint16_t findLowestScore () {
-  // Look for the lowest score
-  uint16_t lowScore = 65535;
-  uint16_t currentScore = 0;
-  uint16_t lowAddress = 0;
-  for (uint16_t i = HS_START; i < HS_END; i += HS_RECORD_SIZE) {
-    currentScore = readUint16_t (i);
-    if (currentScore == 0) return (i);
-    if (currentScore < lowScore) {
-      lowScore = currentScore;
-      lowAddress = i;
+void scenarioBombs (uint8_t frame) {
+  modeState.game.bombMoveCountdown = 0;
+  for (uint8_t i = 0; i < MAX_BOMBS; i ++) {
+    if (!bombs[i].exists ()) {
+      // Somewhere along the defence, a bit further along each time
+      bombs[i].create (15 + (i * 28) + ((frame + (i * 3)) % DEFENCE_WIDTH), DEFENCE_TOP - 8, (i & 1) ? SLOW_BOMB : FAST_BOMB);
     }
-  } 
-  return (lowAddress);
+  }
 }
 
-uint16_t readUint16_t (uint16_t address) {
-  return (EEPROM.read (address) << 8 | EEPROM.read (address + 1));  
+/*
+ * The mystery ship flies along, moving every frame, and is shot halfway
+ * through. Its score stays up for a quarter of the frames, then it goes.
+ */
+void scenarioMystery (uint8_t frame) {
+  GameState &game = modeState.game;
+  if (mystery.exists ()) game.mysteryMoveCountdown = 0;
+  if (frame == SCENARIO_FRAMES / 2) {
+    // Shoot it, wherever it is
+    for (uint8_t x = 0; x < SSD1306_LCDWIDTH; x ++) {
+      uint16_t hit = mystery.collisionDetect (x, SHIP_Y);
+      if (hit) {
+        updateScore (hit);
+        game.mysteryHitCountdown = COUNTDOWN_MYSTERY_HIT;
+        screenUpdateRequired = true;
+        break;
+      }
+    }
+  } else if (frame == (SCENARIO_FRAMES * 3) / 4) {
+    game.mysteryHitCountdown = 0;
+  }
 }
+#endif
@@ -14,99 +14,204 @@
  * Add a screen buffer 
  * Allow the absolute positioning of bitmaps
  * Replace the 5x7 font with an even smaller 5 pixel high font
+ *
+ * Strip mode (SSD1306_STRIP)
+ * The screen buffer takes 1K - half the RAM on an Uno. In strip mode there
+ * isn't one. Instead, the screen is drawn a page at a time into a 128 byte
+ * strip, just before the page is sent, and only when something on that page
+ * has changed. To draw a page we need to know what's on it, so:
+ * - Anything drawn with drawBitmap () or write () (text, the HUD, title
+ *   screens) goes into a display list, 3 bytes per bitmap. clearRect ()
+ *   removes anything that it completely covers.
+ * - Things that move about (aliens, base, laser, bombs, the mystery ship)
+ *   are drawn with drawSprite (), and the defences (which keep their own
+ *   bitmaps in RAM, see defence.cpp) with drawColumns (). These aren't
+ *   remembered. Instead, the renderer function is called for each page, and
+ *   draws them all from the game state. Outside of the renderer, they only
+ *   mark the area as changed.
+ * RAM: the driver is 1043 bytes of .bss in buffer mode (1024 buffer, 16
+ * update areas, 3 cursor and reset) and 439 in strip mode (128 strip, 288
+ * list, 16 update areas and 7 more) - 604 bytes saved on the Arduino. (The
+ * host builds agree: 1043 and 456 bytes, the extra being its 8 byte
+ * pointer and padding, and .bss 592 bytes smaller.)
+ * Ten minutes of the demo and a game on the host never had more than 77
+ * things in the display list. On the host a full list stops everything, so
+ * tools/host.py --displays would catch a screen that outgrew it.
+ * CPU: SCENARIO_BENCH prints the pages drawn and the time each took. On the
+ * host the scenarios draw 181 pages in 40 frames of the march, 92 with the
+ * bombs, 47 for the mystery ship and 259 with everything going - 1 to 7 a
+ * frame. The PC draws a page in under a microsecond, so that's no guide to
+ * the Arduino, where it's the RENDER column to look at. Only the changed
+ * part of a page is sent, as in buffer mode, so the bytes sent are much the
+ * same (the march sends 972 a frame against 1000). Buffer mode stays the
+ * default.
  */
 #include <avr/pgmspace.h>
 #include "SSD1306.h"
 #include "bitmaps.h"
-#include <SPI.h>
-#include <Wire.h>
+#include "latency.h"
+#include "scenario.h"
+#include "trace.h"
+#include "hal.h"
+#ifdef HAL_HOST
+#include <stdio.h>
+#include <stdlib.h>
+#include "host_panel.h"
+#endif
+
+// Shorthand for the driver's member functions
+#define OLED_TEMPLATE template <uint8_t WIDTH, uint8_t HEIGHT, class Controller, class Transport>
+#define OLED_CLASS OledDisplay<WIDTH, HEIGHT, Controller, Transport>
+
+/*
+ * I2C
+ * Each transmission starts with a control byte, saying whether a command or
+ * data follows. The Wire buffer is only 32 bytes, so data goes 16 bytes at a
+ * time, each with its own control byte (Co set on all but the last).
+ */
+void OledI2c::begin () {
+  I2c::begin (800000); // Super fast 800 KHz
+}
+
+void OledI2c::command (uint8_t c) {
+  I2c::start (OLED_ADDR);
+  I2c::write (0x00);      // Co = 0, D/C = 0
+  I2c::write (c);
+  I2c::stop ();
+  SCENARIO_SENT (3);      // Address, control byte and command
+}
+
+void OledI2c::data (const uint8_t *bytes, uint16_t count) {
+  TRACE_SCOPE (TRACE_SEND);
+  uint8_t i2cCount = 0;
+  if (count == 0) return;
+  // An address for each transmission, and a control byte for each data byte
+  SCENARIO_SENT ((count * 2) + ((count + 15) / 16));
+  I2c::start (OLED_ADDR);
+  for (uint16_t i = 1; i <= count; i ++) {
+    uint8_t b = bytes ? *bytes ++ : 0;
+    // If we're at the end of the data, or the I2C buffer, flag end of data
+    if (i == count || i2cCount == 15) {
+      I2c::write (0x40);
+      I2c::write (b);
+      if (i < count) {
+        // End the transmission and start a new one
+        I2c::stop ();
+        I2c::start (OLED_ADDR);
+        i2cCount = 0;
+      }
+    } else {
+      I2c::write (0xC0);
+      I2c::write (b);
+      i2cCount ++;
+    }
+  }
+  I2c::stop ();
+}
+
+/*
+ * Hardware SPI
+ * The D/C pin says whether it's a command or data, so the data just streams.
+ */
+void OledSpi::begin () {
+  Spi::begin (8000000);
+}
+
+void OledSpi::command (uint8_t c) {
+  Spi::start (false);
+  Spi::write (c);
+  Spi::stop ();
+  SCENARIO_SENT (1);
+}
+
+void OledSpi::data (const uint8_t *bytes, uint16_t count) {
+  TRACE_SCOPE (TRACE_SEND);
+  Spi::start (true);
+  SCENARIO_SENT (count);
+  while (count --) {
+    Spi::write (bytes ? *bytes ++ : 0);
+  }
+  Spi::stop ();
+}
 
 /*
  * Initialise the display
  */
-void SSD1306::init() {
+OLED_TEMPLATE void OLED_CLASS::init() {
   cursor_x = 0;
   cursor_y = 0;
 
   // set pin directions
   if (rst_ != -1) pinMode(rst_, OUTPUT);
 
-  // Set up I2C
-  Wire.begin();
-  Wire.setClock (800000); // Super fast 800 KHz
+  Transport::begin ();
 
   // Reset
   if (rst_ > 0) {
     digitalWrite(rst_, HIGH);
-    delay(1);
+    Clock::delay(1);
     digitalWrite(rst_, LOW);
-    delay(10);
+    Clock::delay(10);
     digitalWrite(rst_, HIGH);
   }
 
-  // Init sequence for 128x64 OLED module
-  sendCommand(SSD1306_DISPLAYOFF);          // 0xAE
-  sendCommand(SSD1306_SETDISPLAYCLOCKDIV);  // 0xD5
-  sendCommand(0x80);                        // the suggested ratio 0x80
-  sendCommand(SSD1306_SETMULTIPLEX);        // 0xA8
-  sendCommand(0x3F);
-  sendCommand(SSD1306_SETDISPLAYOFFSET);    // 0xD3
-  sendCommand(0x0);                         // no offset
-  sendCommand(SSD1306_SETSTARTLINE | 0x0);  // line #0
-  sendCommand(SSD1306_CHARGEPUMP);          // 0x8D
-  sendCommand(0x14);
-  sendCommand(SSD1306_MEMORYMODE);          // 0x20
-  sendCommand(0x00);        // was: 0x2 page mode
-  sendCommand(SSD1306_SEGREMAP | 0x1);
-  sendCommand(SSD1306_COMSCANDEC);
-  sendCommand(SSD1306_SETCOMPINS);          // 0xDA
-  sendCommand(0x12);
-  sendCommand(SSD1306_SETCONTRAST);         // 0x81
-  sendCommand(0xCF);
-  sendCommand(SSD1306_SETPRECHARGE);        // 0xd9
-  sendCommand(0xF1);
-  sendCommand(SSD1306_SETVCOMDETECT);       // 0xDB
-  sendCommand(0x40);
-  sendCommand(SSD1306_DISPLAYALLON_RESUME); // 0xA4
-  sendCommand(SSD1306_NORMALDISPLAY);       // 0xA6
+  // Init sequence (the settings that differ come from the controller)
+  Transport::command(SSD1306_DISPLAYOFF);          // 0xAE
+  Transport::command(SSD1306_SETDISPLAYCLOCKDIV);  // 0xD5
+  Transport::command(Controller::CLOCK_DIV);
+  Transport::command(SSD1306_SETMULTIPLEX);        // 0xA8
+  Transport::command(HEIGHT - 1);
+  Transport::command(SSD1306_SETDISPLAYOFFSET);    // 0xD3
+  Transport::command(0x0);                         // no offset
+  Transport::command(SSD1306_SETSTARTLINE | 0x0);  // line #0
+  if (Controller::PUMP) {
+    Transport::command(Controller::PUMP);          // 0x8D (0xAD on the SH1106)
+    Transport::command(Controller::PUMP_ON);
+  }
+  if (Controller::HORIZONTAL) {
+    Transport::command(SSD1306_MEMORYMODE);        // 0x20
+    Transport::command(0x00);        // was: 0x2 page mode
+  }
+  Transport::command(SSD1306_SEGREMAP | 0x1);
+  Transport::command(SSD1306_COMSCANDEC);
+  Transport::command(SSD1306_SETCOMPINS);          // 0xDA
+  Transport::command(HEIGHT == 32 ? 0x02 : 0x12);  // 128x32 panels have their rows wired in order
+  Transport::command(SSD1306_SETCONTRAST);         // 0x81
+  Transport::command(Controller::CONTRAST);
+  Transport::command(SSD1306_SETPRECHARGE);        // 0xd9
+  Transport::command(Controller::PRECHARGE);
+  Transport::command(SSD1306_SETVCOMDETECT);       // 0xDB
+  Transport::command(Controller::VCOM);
+  Transport::command(SSD1306_DISPLAYALLON_RESUME); // 0xA4
+  Transport::command(SSD1306_NORMALDISPLAY);       // 0xA6
   
-  sendCommand(SSD1306_DISPLAYON);//--turn on oled panel
+  Transport::command(SSD1306_DISPLAYON);//--turn on oled panel
 }
 
 
 /* 
  * Clear the screen
  */
-void SSD1306::clear() {
-  sendCommand(SSD1306_COLUMNADDR);
-  sendCommand(0);   // Column start address (0 = reset)
-  sendCommand(SSD1306_LCDWIDTH-1); // Column end address (127 = reset)
-
-  sendCommand(SSD1306_PAGEADDR);
-  sendCommand(0); // Page start address (0 = reset)
-  sendCommand(7); // Page end address
-
-  // Clear all but the last byte
-  for (int i = 0; i < (SSD1306_LCDWIDTH * SSD1306_LCDHEIGHT / 8 / 16); i++) {
-    Wire.beginTransmission(SSD1306_I2C_ADDRESS);
-    // I2C buffer size is 32 bytes
-    for (int j = 0; j < 15; j ++) {
-      Wire.write(0xC0);
-      Wire.write(0x00);
+OLED_TEMPLATE void OLED_CLASS::clear() {
+  if (Controller::HORIZONTAL) {
+    // Send the whole screen in one go
+    setWindow ();
+    Transport::data (NULL, WIDTH * PAGES);
+    setWindow ();
+  } else {
+    for (uint8_t page = 0; page < PAGES; page ++) {
+      setPosition (page, 0);
+      Transport::data (NULL, WIDTH);
     }
-    Wire.write(0x40);
-    Wire.write(0x00);
-    Wire.endTransmission();
   }
-  sendCommand(SSD1306_COLUMNADDR);
-  sendCommand(0);   // Column start address (0 = reset)
-  sendCommand(SSD1306_LCDWIDTH-1); // Column end address (127 = reset)
-
-  sendCommand(SSD1306_PAGEADDR);
-  sendCommand(0); // Page start address (0 = reset)
-  sendCommand(7); // Page end address
   // Clear the buffer and update area
+#ifdef SSD1306_STRIP
+  itemCount = 0;
+  renderer = NULL;
+  renderingPage = -1;
+#else
   memset (buffer, 0, sizeof(buffer));
+#endif
   memset (updateArea, 0, sizeof(updateArea));
   cursor_x = cursor_y = 0;
 }
@@ -115,35 +220,46 @@ void SSD1306::clear() {
  * Update the screen, only sending the changes
  */
 
-void SSD1306::update () {
-  for (int i = 0; i < SSD1306_PAGES; i ++) {
+OLED_TEMPLATE void OLED_CLASS::update () {
+  TRACE_SCOPE (TRACE_UPDATE);
+  for (int i = 0; i < PAGES; i ++) {
     updatePage (i);
   }
+#if defined (HAL_HOST) && !defined (SSD1306_STRIP)
+  // Make sure the stand-in display got all of it
+  hostPanel.check (buffer[0], 0, PAGES, WIDTH, Controller::COLUMN_OFFSET);
+#endif
 }
 
 /*
  * Update a single page, if required
  */
-void SSD1306::updatePage (int page) {
+OLED_TEMPLATE void OLED_CLASS::updatePage (int page) {
   if (updateArea[page][1] + updateArea[page][0] != 0) {
-    // Set display cursor address
-    sendCommand(SSD1306_SETLOWCOLUMN | (updateArea[page][0] & 0XF));
-    sendCommand(SSD1306_SETHIGHCOLUMN | (updateArea[page][0] >> 4));
-    sendCommand(SSD1306_SETSTARTPAGE | page);
-    sendFromBuffer ((uint8_t*)buffer[page], updateArea[page][0], updateArea[page][1]);
+    setPosition (page, updateArea[page][0]);
+#ifdef SSD1306_STRIP
+    renderPage (page);
+    Transport::data (strip + updateArea[page][0], updateArea[page][1] - updateArea[page][0]);
+#ifdef HAL_HOST
+    hostPanel.check (strip, page, 1, WIDTH, Controller::COLUMN_OFFSET);
+#endif
+#else
+    Transport::data (buffer[page] + updateArea[page][0], updateArea[page][1] - updateArea[page][0]);
+#endif
     updateArea[page][0] = updateArea[page][1] = 0;
+    LATENCY_SENT (page);
   }
 }
 
 /*
  * Set the cursor position from the top left corner = 0, 0
  */
-void SSD1306::setCursor(uint8_t x, uint8_t y) {
-  if (y >= SSD1306_LCDHEIGHT) {
-    y = SSD1306_LCDHEIGHT - 1;
+OLED_TEMPLATE void OLED_CLASS::setCursor(uint8_t x, uint8_t y) {
+  if (y >= HEIGHT) {
+    y = HEIGHT - 1;
   }
-  if (x >= SSD1306_LCDWIDTH) {
-    x = SSD1306_LCDWIDTH - 1;
+  if (x >= WIDTH) {
+    x = WIDTH - 1;
   }
   cursor_y = y; // row is 1 pixels tall
   cursor_x = x; // col is 1 pixel wide
@@ -152,8 +268,8 @@ void SSD1306::setCursor(uint8_t x, uint8_t y) {
 /*
  * Write a single character to the display
  */
-size_t SSD1306::write(uint8_t c) {
-  if (cursor_x >= SSD1306_LCDWIDTH) return 0;
+OLED_TEMPLATE size_t OLED_CLASS::write(uint8_t c) {
+  if (cursor_x >= WIDTH) return 0;
   // If printable
   if (c >= 32 && c <= 126) {
     // Pull the bitmap offset from the character table
@@ -166,11 +282,11 @@ size_t SSD1306::write(uint8_t c) {
   }
   // Move the cursor
   cursor_x += charWidth (c);
-  if (cursor_x > SSD1306_LCDWIDTH) {
-    cursor_x = cursor_x % SSD1306_LCDWIDTH;
+  if (cursor_x > WIDTH) {
+    cursor_x = cursor_x % WIDTH;
     cursor_y += 6;
-    if (cursor_y > SSD1306_LCDHEIGHT) {
-      cursor_y = cursor_y % SSD1306_LCDHEIGHT;
+    if (cursor_y > HEIGHT) {
+      cursor_y = cursor_y % HEIGHT;
     }
   }
   return 1;
@@ -180,7 +296,7 @@ size_t SSD1306::write(uint8_t c) {
  * Although it's a variable width charset, only M, N & W are not 3 pixels wide
  * So rather than use a width table, use this ugly hack ;-) 
  */
-uint8_t SSD1306::charWidth (uint8_t c) {
+OLED_TEMPLATE uint8_t OLED_CLASS::charWidth (uint8_t c) {
   switch (c) {
     case 'M':
     case 'W':
@@ -196,7 +312,7 @@ uint8_t SSD1306::charWidth (uint8_t c) {
 /*
  * Write a string to the display
  */
-size_t SSD1306::write(const char* s) {
+OLED_TEMPLATE size_t OLED_CLASS::write(const char* s) {
   size_t n = strlen(s);
   for (size_t i = 0; i < n; i++) {
     write(s[i]);
@@ -204,7 +320,7 @@ size_t SSD1306::write(const char* s) {
   return n;
 }
 
-size_t SSD1306::write(const __FlashStringHelper* s) {
+OLED_TEMPLATE size_t OLED_CLASS::write(const __FlashStringHelper* s) {
   size_t n = 0;
   uint8_t c;
   while (true) {
@@ -222,7 +338,7 @@ size_t SSD1306::write(const __FlashStringHelper* s) {
 /*
  * write an integer to the display
  */
-void SSD1306::writeInt(uint16_t i) {  // slightly smaller than system print()
+OLED_TEMPLATE void OLED_CLASS::writeInt(uint16_t i) {  // slightly smaller than system print()
     char buffer[7];
     itoa(i, buffer, 10);
     write(buffer);
@@ -231,7 +347,7 @@ void SSD1306::writeInt(uint16_t i) {  // slightly smaller than system print()
 /*
  * Write the score to the display (zero padded with trailing zero
  */
-void SSD1306::writeScore (uint16_t s) {
+OLED_TEMPLATE void OLED_CLASS::writeScore (uint16_t s) {
   if (s < 1000) write ('0');
   if (s < 100) write ('0');
   if (s < 10) write ('0');
@@ -239,82 +355,88 @@ void SSD1306::writeScore (uint16_t s) {
   write ('0');
 }
 /*
- * Send a command to the display
+ * Set the display cursor address
  */
-void SSD1306::sendCommand(uint8_t c) {
-    uint8_t control = 0x00;   // Co = 0, D/C = 0
-    Wire.beginTransmission(SSD1306_I2C_ADDRESS);
-    Wire.write(control);
-    Wire.write(c);
-    Wire.endTransmission();
+OLED_TEMPLATE void OLED_CLASS::setPosition (uint8_t page, uint8_t x) {
+  x += Controller::COLUMN_OFFSET;
+  Transport::command(SSD1306_SETLOWCOLUMN | (x & 0XF));
+  Transport::command(SSD1306_SETHIGHCOLUMN | (x >> 4));
+  Transport::command(SSD1306_SETSTARTPAGE | page);
 }
-//------------------------------------------------------------------------------
+
 /*
- * Send bitmap data to the display
+ * Set the area written to (with horizontal addressing) to the whole screen,
+ * starting at the top left
  */
-void SSD1306::sendData(uint8_t c) {
-    uint8_t control = 0x40;   // Co = 0, D/C = 1
-    Wire.beginTransmission(SSD1306_I2C_ADDRESS);
-    Wire.write(control);
-    Wire.write(c);
-    Wire.endTransmission();
+OLED_TEMPLATE void OLED_CLASS::setWindow () {
+  Transport::command(SSD1306_COLUMNADDR);
+  Transport::command(0);   // Column start address (0 = reset)
+  Transport::command(WIDTH-1); // Column end address (127 = reset)
+
+  Transport::command(SSD1306_PAGEADDR);
+  Transport::command(0); // Page start address (0 = reset)
+  Transport::command(PAGES-1); // Page end address
+}
+
+OLED_TEMPLATE void OLED_CLASS::setUpdateArea (uint8_t page, uint8_t x1, uint8_t x2) {
+  if ((updateArea[page][0] + updateArea[page][1]) == 0) {
+    updateArea[page][0] = x1;
+  } else {
+    updateArea[page][0] = min (updateArea[page][0], x1);
+  }
+  updateArea[page][1] = max (updateArea[page][1], x2);
 }
 
 /*
- * Send bitmap data to the display from a buffer
- */
-void SSD1306::sendFromBuffer (uint8_t* addr, int start, int stop) {
-  int i2cCount = 0;
-  stop --; // Decrement the count to speed up last byte detection
-  Wire.beginTransmission(SSD1306_I2C_ADDRESS);
-  for (int i = start; i <= stop; i ++) { 
-    // If we're at the end of the bitmap, flag end of data
-    if (i == stop) {
-      // End of bitmap, send end of data flag
-      Wire.write (0x40);
-      Wire.write (addr[i]);
-    } else {
-      // Are we at the end of the I2C buffer?
-      if (i2cCount == 15) {
-        // send end of data flag
-        Wire.write (0x40);
-        Wire.write (addr[i]);
-        // End the transmission
-        Wire.endTransmission ();
-        // And start a new one
-        Wire.beginTransmission (SSD1306_I2C_ADDRESS);
-        // Reset i2c buffer count
-        i2cCount = 0;
-      } else {
-        Wire.write (0xC0);
-        Wire.write (addr[i]);
-        // increment i2c buffer count
-        i2cCount ++;
-      }
+ * Start reading a bitmap from progmem
+ */
+BitmapReader::BitmapReader (uint16_t bitmapOffset) {
+  pointer = bitmaps + bitmapOffset;
+  column = end = 0;
+  repeat = 0;
+}
+
+/*
+ * Get the next column of the bitmap
+ * Ordinary columns are passed straight through. A run byte means the column
+ * before is repeated, so it's handed out again without touching progmem.
+ */
+uint8_t BitmapReader::next () {
+  if (repeat == 0) {
+    uint8_t b = pgm_read_byte (pointer ++);
+    if (!(b & BITMAP_RUN)) {
+      column = b & BITMAP_COLUMN;
+      return (b);
     }
+    repeat = (b & BITMAP_COLUMN) + 1;
+    end = b & BITMAP_END;
   }
-  Wire.endTransmission();
+  repeat --;
+  // The end marker goes on the last repeat
+  return (repeat ? column : column | end);
 }
 
+#ifndef SSD1306_STRIP
 /*
  * Copy a bitmap from the bitmaps stored in progmem into the screen buffer
  * at the coordinate provided. Bitmaps are overlaid, leaving any pixels previous
  * set.
  * All bitmaps are 5 pixels high and are terminated when the MSB is set.
  */
-void SSD1306::drawBitmap (uint16_t bitmapOffset, uint8_t x, uint8_t y) {
+OLED_TEMPLATE void OLED_CLASS::drawBitmap (uint16_t bitmapOffset, uint8_t x, uint8_t y) {
+  TRACE_SCOPE_SIM (TRACE_DRAW_BITMAP);
   uint8_t page1 = y / 8;
   uint8_t page2 = page1 + 1;
   uint8_t shift1 = y % 8;
   uint8_t shift2 = 8 - shift1;
   uint8_t b1, b2;
-  uint8_t* pointer = bitmaps + bitmapOffset;
+  BitmapReader reader (bitmapOffset);
   boolean notFinished = true;
   uint8_t x2 = x;  // take a copy of x
 
   do {
-    // Get a slice of the bitmap and increment the pointer
-    b1 = b2 = pgm_read_byte (pointer ++);
+    // Get a slice of the bitmap
+    b1 = b2 = reader.next ();
     // Is the end marker set?
     if (b1 >= 128) {
       // Strip the marker
@@ -344,7 +466,7 @@ void SSD1306::drawBitmap (uint16_t bitmapOffset, uint8_t x, uint8_t y) {
 /*
  * Clear rectangle in the buffer
  */
-void SSD1306::clearRect (uint8_t x, uint8_t y, uint8_t w, uint8_t h) {
+OLED_TEMPLATE void OLED_CLASS::clearRect (uint8_t x, uint8_t y, uint8_t w, uint8_t h) {
   uint8_t y2 = y + h;
   uint8_t shift1 = y % 8;
   uint8_t shift2 = y2 % 8;
@@ -379,10 +501,10 @@ void SSD1306::clearRect (uint8_t x, uint8_t y, uint8_t w, uint8_t h) {
 /*
  * Dump the contents of the buffer to the serial port
  */
-void SSD1306::dumpBuffer () {
-  for (int i = 0; i < SSD1306_PAGES; i ++) {
+OLED_TEMPLATE void OLED_CLASS::dumpBuffer () {
+  for (int i = 0; i < PAGES; i ++) {
     for (uint8_t b = 0; b < 8; b ++) {
-      for (int j = 0; j < SSD1306_LCDWIDTH; j ++) {
+      for (int j = 0; j < WIDTH; j ++) {
         Serial.print ((buffer[i][j] & (1 << b)) ? "#" : " ");
       }
       Serial.println ();
@@ -390,27 +512,209 @@ void SSD1306::dumpBuffer () {
   }
 }
 
-void SSD1306::setUpdateArea (uint8_t page, uint8_t x1, uint8_t x2) {
-  if ((updateArea[page][0] + updateArea[page][1]) == 0) {
-    updateArea[page][0] = x1;
-  } else {
-    updateArea[page][0] = min (updateArea[page][0], x1);
+/*
+ * Sprites are just bitmaps when there's a screen buffer
+ */
+OLED_TEMPLATE void OLED_CLASS::drawSprite (uint16_t bitmapOffset, uint8_t x, uint8_t y) {
+  drawBitmap (bitmapOffset, x, y);
+}
+
+/*
+ * Overlay a bitmap held in RAM (one byte per column, 5 pixels high)
+ * Only the bytes that actually change are marked for sending, so drawing it
+ * again over itself costs nothing.
+ */
+OLED_TEMPLATE void OLED_CLASS::drawColumns (const uint8_t *columns, uint8_t width, uint8_t x, uint8_t y) {
+  uint8_t page = y / 8;
+  uint8_t shift = y % 8;
+  uint8_t b;
+  for (uint8_t i = 0; i < width; i ++, x ++) {
+    b = buffer[page][x] | (columns[i] << shift);
+    if (b != buffer[page][x]) {
+      buffer[page][x] = b;
+      setUpdateArea (page, x, x + 1);
+    }
+    // Does it go over into the next page?
+    if (shift > 3) {
+      b = buffer[page + 1][x] | (columns[i] >> (8 - shift));
+      if (b != buffer[page + 1][x]) {
+        buffer[page + 1][x] = b;
+        setUpdateArea (page + 1, x, x + 1);
+      }
+    }
   }
-  updateArea[page][1] = max (updateArea[page][1], x2);
 }
 
 /*
  * returns true if the pixel is set, otherwise, false
  */
-boolean SSD1306::readPixel (uint8_t x, uint8_t y) {
+OLED_TEMPLATE boolean OLED_CLASS::readPixel (uint8_t x, uint8_t y) {
   return ((1 << (y % 8)) & buffer[y / 8][x]);
 }
 
 /*
  * Clear pixel
  */
-void SSD1306::clearPixel (uint8_t x, uint8_t y) {
+OLED_TEMPLATE void OLED_CLASS::clearPixel (uint8_t x, uint8_t y) {
   uint8_t page = y / 8;
   buffer[page][x] = buffer[page][x] & ~(1 << (y % 8));
-  setUpdateArea (page, x, x);
+  setUpdateArea (page, x, x + 1);
+}
+
+#else
+
+/*
+ * Draw the page into the strip - the moving things, then the display list
+ */
+OLED_TEMPLATE void OLED_CLASS::renderPage (uint8_t page) {
+  SCENARIO_RENDER_START ();
+  memset (strip, 0, sizeof (strip));
+  renderingPage = page;
+  if (renderer) renderer ();
+  for (uint8_t i = 0; i < itemCount; i ++) {
+    drawBitmap (itemBitmap (items[i]), items[i].x & 0x7F, items[i].y & 0x3F);
+  }
+  renderingPage = -1;
+  SCENARIO_RENDER_END ();
+}
+
+/*
+ * Draw a bitmap
+ * While rendering, it's drawn into the strip (if it's on the page being drawn).
+ * Otherwise it's added to the display list.
+ */
+OLED_TEMPLATE void OLED_CLASS::drawBitmap (uint16_t bitmapOffset, uint8_t x, uint8_t y) {
+  TRACE_SCOPE_SIM (TRACE_DRAW_BITMAP);
+  if (renderingPage >= 0) {
+    // Skip anything that isn't on this page
+    uint8_t page = y / 8;
+    if (page != renderingPage && (page + 1 != renderingPage || y % 8 <= 3)) return;
+    BitmapReader reader (bitmapOffset);
+    uint8_t b;
+    do {
+      b = reader.next ();
+      stripColumn (x ++, y, b & BITMAP_COLUMN);
+    } while (b < 128);
+    return;
+  }
+  // If it's full, the bitmap is lost (make SSD1306_DISPLAY_LIST bigger)
+  if (itemCount < SSD1306_DISPLAY_LIST) {
+    SSD1306Item &item = items[itemCount ++];
+    item.x = x | ((bitmapOffset >> 3) & 0x80);
+    item.y = y | ((bitmapOffset >> 2) & 0xC0);
+    item.bitmap = bitmapOffset;
+  } else {
+#ifdef HAL_HOST
+    // There's no telling on the Arduino, so stop here
+    fprintf (stderr, "DISPLAY LIST FULL bitmap %u at %u,%u\n", bitmapOffset, x, y);
+    abort ();
+#endif
+  }
+  setBitmapArea (bitmapOffset, x, y);
 }
+
+/*
+ * Draw a sprite. Sprites are drawn by the renderer, so unless we're rendering,
+ * all that's needed is to mark the area as changed.
+ */
+OLED_TEMPLATE void OLED_CLASS::drawSprite (uint16_t bitmapOffset, uint8_t x, uint8_t y) {
+  if (renderingPage >= 0) {
+    drawBitmap (bitmapOffset, x, y);
+  } else {
+    setBitmapArea (bitmapOffset, x, y);
+  }
+}
+
+/*
+ * Draw a bitmap held in RAM (one byte per column, 5 pixels high)
+ * Like sprites, these are drawn by the renderer.
+ */
+OLED_TEMPLATE void OLED_CLASS::drawColumns (const uint8_t *columns, uint8_t width, uint8_t x, uint8_t y) {
+  if (renderingPage >= 0) {
+    for (uint8_t i = 0; i < width; i ++) {
+      stripColumn (x + i, y, columns[i]);
+    }
+  } else {
+    setUpdateArea (y / 8, x, x + width);
+    if (y % 8 > 3) setUpdateArea ((y / 8) + 1, x, x + width);
+  }
+}
+
+/*
+ * Put one column of a bitmap into the strip, if it's on the page being drawn
+ */
+OLED_TEMPLATE void OLED_CLASS::stripColumn (uint8_t x, uint8_t y, uint8_t b) {
+  if (x >= WIDTH) return;
+  uint8_t page = y / 8;
+  if (page == renderingPage) {
+    strip[x] |= b << (y % 8);
+  } else if (page + 1 == renderingPage) {
+    strip[x] |= b >> (8 - (y % 8));
+  }
+}
+
+/*
+ * Clear a rectangle
+ * While rendering, this clears the strip. Otherwise, bitmaps in the display
+ * list that are completely inside the rectangle are removed.
+ */
+OLED_TEMPLATE void OLED_CLASS::clearRect (uint8_t x, uint8_t y, uint8_t w, uint8_t h) {
+  uint8_t x2 = x + w;
+  uint8_t y2 = y + h;
+  if (renderingPage >= 0) {
+    uint8_t top = renderingPage * 8;
+    if (y2 <= top || y >= top + 8) return;
+    // Pixels in the page to clear
+    uint8_t mask = 0xFF;
+    if (y > top) mask = mask << (y - top);
+    if (y2 < top + 8) mask = mask & (0xFF >> (top + 8 - y2));
+    for (uint8_t i = x; i < x2 && i < WIDTH; i ++) {
+      strip[i] = strip[i] & ~mask;
+    }
+    return;
+  }
+  // Remove the display list items
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < itemCount; i ++) {
+    uint8_t ix = items[i].x & 0x7F;
+    uint8_t iy = items[i].y & 0x3F;
+    if (!(ix >= x && ix + bitmapWidth (itemBitmap (items[i])) <= x2 && iy >= y && iy + 5 <= y2)) {
+      items[kept ++] = items[i];
+    }
+  }
+  itemCount = kept;
+  for (uint8_t page = y / 8; page <= (y2 - 1) / 8; page ++) {
+    setUpdateArea (page, x, x2);
+  }
+}
+
+/*
+ * Mark the area a bitmap covers as changed
+ */
+OLED_TEMPLATE void OLED_CLASS::setBitmapArea (uint16_t bitmapOffset, uint8_t x, uint8_t y) {
+  uint8_t x2 = min (x + bitmapWidth (bitmapOffset), WIDTH);
+  setUpdateArea (y / 8, x, x2);
+  if (y % 8 > 3) setUpdateArea ((y / 8) + 1, x, x2);
+}
+
+/*
+ * Bitmaps end with the MSB set, so we have to look for it
+ */
+OLED_TEMPLATE uint8_t OLED_CLASS::bitmapWidth (uint16_t bitmapOffset) {
+  BitmapReader reader (bitmapOffset);
+  uint8_t width = 1;
+  while (reader.next () < 128) width ++;
+  return (width);
+}
+
+/*
+ * Unpack the bitmap offset from a display list item
+ */
+OLED_TEMPLATE uint16_t OLED_CLASS::itemBitmap (const SSD1306Item &item) {
+  return (item.bitmap | ((item.y & 0xC0) << 2) | ((item.x & 0x80) << 3));
+}
+
+#endif
+
+// Build the display picked in hardware.h
+template class OledDisplay<OLED_WIDTH, OLED_HEIGHT, OLED_CONTROLLER, OLED_TRANSPORT>;
@@ -15,16 +15,24 @@
  * Add a screen buffer 
  * Allow the absolute positioning of bitmaps
  * Replace the 5x7 font with an even smaller 5 pixel high font
+ * Make it a template for the size of the panel, the controller (SSD1306,
+ * SSD1309 or SH1106) and how it's connected (I2C or SPI)
  */
 #ifndef SSD1306_h
 #define SSD1306_h 
 #include "Arduino.h"
+#include "hal.h"
 
-#define SSD1306_LCDWIDTH  128
-#define SSD1306_LCDHEIGHT  64
-#define SSD1306_PAGES (SSD1306_LCDHEIGHT / 8)
+// The size of the screen the game is drawn on (the panel picked in hardware.h)
+#define SSD1306_LCDWIDTH OLED_WIDTH
+#define SSD1306_LCDHEIGHT OLED_HEIGHT
 
-#define SSD1306_I2C_ADDRESS   0x3C  // 011110+SA0+RW - 0x3C or 0x3D
+/*
+ * Uncomment to do without the screen buffer (see SSD1306.cpp). Saves about
+ * half a K of RAM, at the cost of redrawing each page whenever it changes.
+ */
+//#define SSD1306_STRIP
+#define SSD1306_DISPLAY_LIST 96     // Bitmaps and characters that can be on the screen at once in strip mode
 
 #define SSD1306_SETCONTRAST 0x81
 #define SSD1306_DISPLAYALLON_RESUME 0xA4
@@ -60,14 +68,121 @@
 #define SSD1306_SEGREMAP 0xA0
 
 #define SSD1306_CHARGEPUMP 0x8D
+#define SH1106_DCDC 0xAD
 
 #define SSD1306_EXTERNALVCC 0x1
 #define SSD1306_SWITCHCAPVCC 0x2
 
-class SSD1306 {
+// Draws the moving parts of the screen, when asked to (strip mode only)
+typedef void (*SSD1306Renderer) ();
+
+/*
+ * Bitmaps (see bitmaps.h) have a byte per column, with the MSB set on the
+ * last one. A byte with BITMAP_RUN set isn't a column, it repeats the column
+ * before another (bits 0-4) + 1 times. The title is mostly runs, so this
+ * shrinks it quite a bit. tools/assets.py puts the runs in.
+ */
+#define BITMAP_END 0x80
+#define BITMAP_RUN 0x40
+#define BITMAP_COLUMN 0x1F          // The pixels of a column (or the length of a run - 1)
+
+/*
+ * Reads a bitmap from progmem a column at a time, unpacking any runs
+ */
+class BitmapReader {
+  public:
+    BitmapReader (uint16_t bitmapOffset);
+    uint8_t next ();                // The next column, with BITMAP_END set on the last one
+
+  private:
+    const uint8_t *pointer;
+    uint8_t column;                 // The column being repeated
+    uint8_t repeat;                 // How many more times
+    uint8_t end;                    // BITMAP_END if the run ends the bitmap
+};
+
+#ifdef SSD1306_STRIP
+/*
+ * A bitmap on the screen, packed into 3 bytes:
+ * x - bits 0-6 x coordinate, bit 7 bitmap offset bit 10
+ * y - bits 0-5 y coordinate, bits 6-7 bitmap offset bits 8-9
+ * bitmap - bitmap offset bits 0-7
+ */
+struct SSD1306Item {
+  uint8_t x;
+  uint8_t y;
+  uint8_t bitmap;
+};
+#endif
+
+/*
+ * The controllers
+ * They all take much the same commands, but want different settings. The
+ * SH1106 has 132 columns of memory for 128 pixels, and can only be written
+ * a page at a time.
+ */
+struct SSD1306Controller {
+  static const boolean HORIZONTAL = true;   // Has horizontal addressing (the whole screen can be sent in one go)
+  static const uint8_t COLUMN_OFFSET = 0;   // The first column of memory that's on the screen
+  static const uint8_t PUMP = SSD1306_CHARGEPUMP; // The command to set up the charge pump (0 if there isn't one)
+  static const uint8_t PUMP_ON = 0x14;
+  static const uint8_t CLOCK_DIV = 0x80;
+  static const uint8_t CONTRAST = 0xCF;
+  static const uint8_t PRECHARGE = 0xF1;
+  static const uint8_t VCOM = 0x40;
+};
+
+struct SSD1309Controller {
+  static const boolean HORIZONTAL = true;
+  static const uint8_t COLUMN_OFFSET = 0;
+  static const uint8_t PUMP = 0;            // Needs an external supply
+  static const uint8_t PUMP_ON = 0;
+  static const uint8_t CLOCK_DIV = 0xA0;
+  static const uint8_t CONTRAST = 0xCF;
+  static const uint8_t PRECHARGE = 0xF1;
+  static const uint8_t VCOM = 0x40;
+};
+
+struct SH1106Controller {
+  static const boolean HORIZONTAL = false;
+  static const uint8_t COLUMN_OFFSET = 2;
+  static const uint8_t PUMP = SH1106_DCDC;
+  static const uint8_t PUMP_ON = 0x8B;
+  static const uint8_t CLOCK_DIV = 0x80;
+  static const uint8_t CONTRAST = 0x80;
+  static const uint8_t PRECHARGE = 0x22;
+  static const uint8_t VCOM = 0x35;
+};
+
+/*
+ * The connections (pins and address in hardware.h)
+ */
+struct OledI2c {
+  static void begin ();
+  static void command (uint8_t c);
+  static void data (const uint8_t *bytes, uint16_t count);  // Send bytes from RAM (NULL sends zeros)
+};
+
+struct OledSpi {
+  static void begin ();
+  static void command (uint8_t c);
+  static void data (const uint8_t *bytes, uint16_t count);
+};
+
+/*
+ * The display driver
+ * Everything about the panel is fixed when compiling, so the buffer is just
+ * the right size, and only the commands for the controller are built in.
+ * The code is in SSD1306.cpp, and only the display picked in hardware.h is
+ * built, as SSD1306.
+ */
+template <uint8_t WIDTH, uint8_t HEIGHT, class Controller, class Transport>
+class OledDisplay {
 
  public:
-  SSD1306(int8_t rst) : rst_(rst) {}
+  static const uint8_t PAGES = HEIGHT / 8;
+
+  OledDisplay(int8_t rst) : rst_(rst) {}
 
   void init();
   void clear();
@@ -80,27 +195,47 @@ class SSD1306 {
   void writeScore (uint16_t);
   uint8_t charWidth (uint8_t c);
 
-  void sendCommand(uint8_t c);
-  void sendData(uint8_t c);
-  void sendFromBuffer (uint8_t *, int, int);
   void drawBitmap (uint16_t, uint8_t, uint8_t);
+  void drawSprite (uint16_t, uint8_t, uint8_t);
+  void drawColumns (const uint8_t *columns, uint8_t width, uint8_t x, uint8_t y);  // A bitmap in RAM, one byte per column
   void clearRect (uint8_t, uint8_t, uint8_t, uint8_t);
+#ifdef SSD1306_STRIP
+  void setRenderer (SSD1306Renderer r) { renderer = r; }
+#else
+  void setRenderer (SSD1306Renderer r) {}   // Everything is in the buffer, so there's nothing to render
   boolean readPixel (uint8_t x, uint8_t y);
   void clearPixel (uint8_t, uint8_t);
   void dumpBuffer ();
+#endif
 
  private:
+  void setPosition (uint8_t page, uint8_t x);
+  void setWindow ();
   void updatePage (int);
   void setUpdateArea (uint8_t, uint8_t, uint8_t);
   
   int8_t cursor_x, cursor_y;    // cursor position
-  int8_t data_, clk_, dc_, rst_, cs_; // OLED pins
-
-  volatile uint8_t *mosiport, *clkport, *csport, *dcport;
-  uint8_t mosipinmask, clkpinmask, cspinmask, dcpinmask;
-  
-  void spiWrite(uint8_t c);
-  uint8_t buffer[SSD1306_PAGES][SSD1306_LCDWIDTH];   // screen buffer
-  uint8_t updateArea [SSD1306_PAGES][2]; // beginning and end positions of screen page updates areas
+  int8_t rst_;                  // Reset pin (-1 if there isn't one)
+
+#ifdef SSD1306_STRIP
+  // The display list packs coordinates into 7 and 6 bits
+  static_assert (WIDTH <= 128 && HEIGHT <= 64, "The panel is too big for strip mode");
+  void renderPage (uint8_t page);
+  void stripColumn (uint8_t x, uint8_t y, uint8_t b);
+  void setBitmapArea (uint16_t bitmapOffset, uint8_t x, uint8_t y);
+  uint8_t bitmapWidth (uint16_t bitmapOffset);
+  uint16_t itemBitmap (const SSD1306Item &item);
+  uint8_t strip[WIDTH];                              // The page being drawn
+  SSD1306Item items[SSD1306_DISPLAY_LIST];           // Everything drawn with drawBitmap () / write ()
+  uint8_t itemCount;
+  SSD1306Renderer renderer;                          // Draws everything else
+  int8_t renderingPage;                              // The page in the strip (-1 if not rendering)
+#else
+  uint8_t buffer[PAGES][WIDTH];                      // screen buffer
+#endif
+  uint8_t updateArea [PAGES][2]; // beginning and end positions of screen page updates areas
 };
+
+typedef OledDisplay<OLED_WIDTH, OLED_HEIGHT, OLED_CONTROLLER, OLED_TRANSPORT> SSD1306;
+
 #endif
@@ -11,9 +11,11 @@
 /*
  * Code responsible for maintaining the alien grid
  *
- * The alien grid is held as 5 x 16 bit integers, used as bitfields.
- * Out of the 16 bits, only 11 are used because we only have 11 columns
- * of aliens. These are held in the right most least significant bits
+ * The alien grid is held as one integer per row, used as bitfields.
+ * The standard grid is 5 x 16 bit integers. Out of the 16 bits, only 11
+ * are used because we only have 11 columns of aliens. Bigger formations
+ * (see AlienGridT in alien_grid.h) use 32 or 64 bit rows.
+ * The columns are held in the right most least significant bits
  * and each bit represents the presence of an alien going backwards
  * from left to right. (ie. the LSB in the bitfield is the left most
  * alien on screen).
@@ -21,74 +23,90 @@
  * When all least significant bits from all rows are clear, the bitfields
  * are normalised by rotating right, so that the grid always starts at
  * bit 0.
+ * A summary of the grid is kept up to date as aliens are killed. colMask
+ * has a bit set for every column that still has an alien in it, and
+ * colBottom holds the lowest remaining row of each column. This means that
+ * picking a column to drop a bomb from, and finding where the bomb starts,
+ * doesn't involve searching the grid, however many holes have been shot in
+ * it. Finding the edges of the grid is a matter of finding the lowest and
+ * highest bits set in colMask.
  * Exploding aliens are also controlled here. When an alien is killed
  * it's row and column are stored, so that when the screen is updated
  * it knows where to put the explosion. This is erased on the next
  * movement step. 
+ * None of this touches the screen. erase () and show () bring the screen up
+ * to date afterwards - the whole grid if it has stepped, otherwise just the
+ * alien that was shot and the explosion.
  */
 #include "alien_grid.h"
+#include "trace.h"
 
 /*
  * Set up the alien grid
  */
-void AlienGrid::init (uint8_t start_y) {
-  grid[0] = grid[1] = grid[2] = grid[3] = grid[4] = 0x07FF;
+template <uint8_t ROWS, uint8_t COLS>
+void AlienGridT<ROWS, COLS>::init (uint8_t start_y) {
+  // All columns present
+  colMask = ((Bits)~(Bits)0) >> ((sizeof (Bits) * 8) - COLS);
+  for (uint8_t i = 0; i < ROWS; i ++) {
+    grid[i] = colMask;
+  }
+  memset (colBottom, ROWS - 1, sizeof (colBottom));
   grid_x = AG_START_X;
   grid_y = start_y;
   movingRight = true;
-  cols = AG_COLS;
-  rows = AG_ROWS;
+  cols = COLS;
+  rows = ROWS;
   bang_col = -1;
-  alienCount = (AG_ROWS * AG_COLS);
+  alienCount = (ROWS * COLS);
 }
 
 /*
  * Draw the aliens and explosion, is there is one
  */
-void AlienGrid::draw (SSD1306 &screen) {
+template <uint8_t ROWS, uint8_t COLS>
+void AlienGridT<ROWS, COLS>::draw (SSD1306 &screen) {
   uint8_t x = grid_x + 1; // First row of aliens needs to be offset by 1 pixel
   uint8_t y = grid_y;
-  uint16_t mask;
+  Bits remaining;
   uint8_t bm;
   for (uint8_t i = 0; i < rows; i ++) {
-    mask = 1;
-    bm = pgm_read_byte (&(alienBitmap[i][x & 1]));
-    for (uint8_t j = 0; j < cols; j ++) {
-      // Does an alien exist at this location?
-      if (grid[i] & mask) {
-        screen.drawBitmap (bm, x, y);
-      }
-      x += AG_COLWIDTH;
-      mask = mask << 1;
+    bm = pgm_read_byte (&(alienBitmap[rowType (i)][x & 1]));
+    // Only visit the aliens that exist, lowest bit first, removing each one as we go
+    for (remaining = grid[i]; remaining; remaining = remaining & (remaining - 1)) {
+      screen.drawSprite (bm, x + (agLowBit (remaining) * AG_COLWIDTH), y);
     }
     y += AG_ROWHEIGHT;
     x = grid_x;
   }
   // Draw the explosion if there is one
   if (bang_col != -1) {
-    screen.drawBitmap (BM_EXPLOSION, grid_x + (bang_col * AG_COLWIDTH), grid_y + (bang_row * AG_ROWHEIGHT));
+    screen.drawSprite (BM_EXPLOSION, grid_x + (bang_col * AG_COLWIDTH), grid_y + (bang_row * AG_ROWHEIGHT));
   }
 }
 
 /*
  * Flag the explosion for removal on next step
  */
-void AlienGrid::clearExplosion () {
+template <uint8_t ROWS, uint8_t COLS>
+void AlienGridT<ROWS, COLS>::clearExplosion () {
   removeExplosion = true;
 }
 
 /*
  * Check it there is an explosion being displayed
  */
-boolean AlienGrid::explosionPresent () {
+template <uint8_t ROWS, uint8_t COLS>
+boolean AlienGridT<ROWS, COLS>::explosionPresent () {
   return (bang_col != -1);
 }
 
 /*
- * Clear the alien grid area, move the aliens one step and then re-draw
+ * Move the aliens one step
  */
-void AlienGrid::step (SSD1306 &screen) {
-  clearArea (screen);
+template <uint8_t ROWS, uint8_t COLS>
+void AlienGridT<ROWS, COLS>::step () {
+  TRACE_SCOPE (TRACE_ALIEN_STEP);
   if (alienCount) {
     if (removeExplosion) {
       normaliseGrid ();
@@ -96,7 +114,7 @@ void AlienGrid::step (SSD1306 &screen) {
       removeExplosion = false;
     }
     if (movingRight) {
-      if ((grid_x + (cols * AG_COLWIDTH)) >= 128) {
+      if ((grid_x + (cols * AG_COLWIDTH)) >= SSD1306_LCDWIDTH) {
         movingRight = false;
         grid_y += 3;
       }
@@ -112,14 +130,6 @@ void AlienGrid::step (SSD1306 &screen) {
       grid_x --;
     }
   }
-  draw (screen);
-}
-
-/*
- * Clear the alien grid area
- */
-void AlienGrid::clearArea (SSD1306 &screen) {
-  screen.clearRect (grid_x, grid_y, cols * AG_COLWIDTH, rows * AG_ROWHEIGHT);
 }
 
 /*
@@ -127,7 +137,9 @@ void AlienGrid::clearArea (SSD1306 &screen) {
  * If an alien is hit, it is removed from the grid and explosion put in its place
  * Returns - the number of points for the alien hit, 0 if none
  */
-int AlienGrid::collisionDetect (SSD1306 &screen, uint8_t x, uint8_t y) {
+template <uint8_t ROWS, uint8_t COLS>
+int AlienGridT<ROWS, COLS>::collisionDetect (uint8_t x, uint8_t y) {
+  TRACE_SCOPE (TRACE_ALIEN_COLLISION);
   // Is the laser within the alien grid?
   if (x >= grid_x && x < getRight () && y >= grid_y && y < getBottom ()) {
     // Which row?
@@ -136,23 +148,34 @@ int AlienGrid::collisionDetect (SSD1306 &screen, uint8_t x, uint8_t y) {
       row_y += AG_ROWHEIGHT;
       if (y < row_y) { // by check for < rather than <=, we can avoid the gaps between rows
         // Now check the column
-        uint8_t tmp_x = (x - grid_x) % 9;
-        if (tmp_x >= pgm_read_byte (&(alienBounds[i][0])) && tmp_x <= pgm_read_byte (&(alienBounds[i][1]))) {
+        uint8_t tmp_x = (x - grid_x) % AG_COLWIDTH;
+        if (tmp_x >= pgm_read_byte (&(alienBounds[rowType (i)][0])) && tmp_x <= pgm_read_byte (&(alienBounds[rowType (i)][1]))) {
           // Not in the gap, so check if the alien exists
-          tmp_x = (x - grid_x) / 9;
-          if (grid[i] & (1 << tmp_x)) {
+          tmp_x = (x - grid_x) / AG_COLWIDTH;
+          Bits bit = (Bits)1 << tmp_x;
+          if (grid[i] & bit) {
             // Oooh, we hit one - delete it from the grid
-            grid[i] = grid[i] & ~(1 << tmp_x);
+            grid[i] = grid[i] & ~bit;
             alienCount --;
-            // If there is already an explosion present
-            if (bang_col != -1) {
-              // Remove it
-              screen.clearRect (grid_x + (bang_col * AG_COLWIDTH), grid_y + (bang_row * AG_ROWHEIGHT), AG_COLWIDTH, AG_ROWHEIGHT);
+            // If it was the lowest in its column, find the next one up
+            if (colBottom[tmp_x] == i) {
+              // (counting the rows above from 1, so it never goes below 0)
+              uint8_t above = i;
+              while (above && !(grid[above - 1] & bit)) {
+                above --;
+              }
+              if (above == 0) {
+                // Nothing left in this column
+                colBottom[tmp_x] = AG_NO_ALIEN;
+                colMask = colMask & ~bit;
+              } else {
+                colBottom[tmp_x] = above - 1;
+              }
             }
-            // Set the location of the explosion
+            // Set the location of the explosion (replacing any that's already there)
             bang_col = tmp_x;
             bang_row = i;
-            return (pgm_read_byte (&(alienScore[i])));
+            return (pgm_read_byte (&(alienScore[rowType (i)])));
           }
         }
       }
@@ -165,7 +188,8 @@ int AlienGrid::collisionDetect (SSD1306 &screen, uint8_t x, uint8_t y) {
  * Rearranges the grid if necessary, after a hit.
  * The grid gets smaller as aliens are removed.
  */
-void AlienGrid::normaliseGrid () {
+template <uint8_t ROWS, uint8_t COLS>
+void AlienGridT<ROWS, COLS>::normaliseGrid () {
   // Check to see if the grid has gotten smaller
   // Was the hit on the bottom row?
   if (bang_row == (rows - 1)) {
@@ -180,69 +204,69 @@ void AlienGrid::normaliseGrid () {
   }
   // Was the alien in the left most column?
   if (bang_col == 0) {
-    // If so, check for empty columns on the left
-    uint16_t allCols = grid[0] | grid[1] | grid[2] | grid[3] | grid[4];
-    uint8_t shift = 0;
-    while ((allCols & 1) == 0) {
-      shift ++;
-      allCols = allCols >> 1;
-      grid_x += AG_COLWIDTH;
-    }
+    // If so, drop any empty columns on the left (colMask can't be empty, because there are aliens left)
+    uint8_t shift = agLowBit (colMask);
     if (shift) {
       for (int j = 0; j < rows; j ++) {
         grid[j] = grid[j] >> shift;
       }
+      colMask = colMask >> shift;
+      memmove (colBottom, colBottom + shift, cols - shift);
+      memset (colBottom + cols - shift, AG_NO_ALIEN, shift);
+      grid_x += shift * AG_COLWIDTH;
       cols -= shift;
       bang_col -= shift;
     }
   } else if (bang_col == (cols - 1)) {
-    // check for empty columns on the right
-    uint16_t allCols = grid[0] | grid[1] | grid[2] | grid[3] | grid[4];
-    uint16_t mask = 1 << (cols - 1);
-    while ((allCols & mask) == 0) {
-      cols --;
-      mask = mask >> 1;
-    }
+    // Drop any empty columns on the right (the width is the position of the highest bit)
+    cols = agWidth (colMask);
   }
 }
 
 /*
  * The number of aliens remaining
  */
-uint8_t AlienGrid::getAlienCount () {
+template <uint8_t ROWS, uint8_t COLS>
+uint8_t AlienGridT<ROWS, COLS>::getAlienCount () {
   return (alienCount);
 }
 
 /*
  * Get the coordinates
  */
-uint8_t AlienGrid::getTop () {
+template <uint8_t ROWS, uint8_t COLS>
+uint8_t AlienGridT<ROWS, COLS>::getTop () {
   return (grid_y);
 }
 
-uint8_t AlienGrid::getBottom () {
+template <uint8_t ROWS, uint8_t COLS>
+uint8_t AlienGridT<ROWS, COLS>::getBottom () {
   return (grid_y + (rows * AG_ROWHEIGHT));
 }
 
-uint8_t AlienGrid::getLeft () {
+template <uint8_t ROWS, uint8_t COLS>
+uint8_t AlienGridT<ROWS, COLS>::getLeft () {
   return (grid_x);
 }
 
-uint8_t AlienGrid::getRight () {
+template <uint8_t ROWS, uint8_t COLS>
+uint8_t AlienGridT<ROWS, COLS>::getRight () {
   return (grid_x + (cols * AG_COLWIDTH));
 }
 
 /*
  * Get the number of columns left in the grid
  */
-uint8_t AlienGrid::getCols () {
+template <uint8_t ROWS, uint8_t COLS>
+uint8_t AlienGridT<ROWS, COLS>::getCols () {
   return (cols);
 }
 
 /*
  * Returns the x coord of the middle of the specified column
  */
-uint8_t AlienGrid::getColX (uint8_t col) {
+template <uint8_t ROWS, uint8_t COLS>
+uint8_t AlienGridT<ROWS, COLS>::getColX (uint8_t col) {
   return (grid_x + (col * AG_COLWIDTH) + (AG_COLWIDTH / 2));
 }
 
@@ -250,28 +274,104 @@ uint8_t AlienGrid::getColX (uint8_t col) {
  * Returns the y coord of the lowest alien in the specified column
  * Zero if colummn is empty
  */
-uint8_t AlienGrid::getColY (uint8_t col) {
-  uint16_t mask = 1 << col;
-  for (int8_t i = rows - 1; i >= 0; i --) {
-    if (grid[i] & mask) {
-      return (grid_y + (i * AG_ROWHEIGHT) + AG_ROWHEIGHT);
-    }
-  }
-  return (0);
+template <uint8_t ROWS, uint8_t COLS>
+uint8_t AlienGridT<ROWS, COLS>::getColY (uint8_t col) {
+  uint8_t row = colBottom[col];
+  if (row == AG_NO_ALIEN) return (0);
+  return (grid_y + (row * AG_ROWHEIGHT) + AG_ROWHEIGHT);
 }
 
 /*
  * Find a random column with aliens in it
+ * Every occupied column is equally likely. Pick a number n up to the count
+ * of occupied columns, knock the lowest n bits off the column mask and the
+ * answer is the lowest bit left.
  * Returns the column number
  */
-uint8_t AlienGrid::getRandomColumn () {
+template <uint8_t ROWS, uint8_t COLS>
+uint8_t AlienGridT<ROWS, COLS>::getRandomColumn () {
   if (alienCount == 0) return (0);
-  uint16_t all = grid[0] | grid[1] | grid[2] | grid[3] | grid[4];
-  uint8_t col = random (cols);
-  uint16_t mask = 1 << col;
-  if (all & mask) return (col);
-  for (uint8_t shift = 1;; shift ++) {
-    if (all & (mask << shift)) return (col - shift);
-    if (all & (mask >> shift)) return (col + shift);
+  Bits mask = colMask;
+  uint8_t n = gameRandom.below (agBitCount (mask));
+  while (n --) {
+    mask = mask & (mask - 1);
+  }
+  return (agLowBit (mask));
+}
+
+/*
+ * The row types are spread evenly down the grid
+ * (the compiler turns this into a multiply for the standard grid)
+ */
+template <uint8_t ROWS, uint8_t COLS>
+uint8_t AlienGridT<ROWS, COLS>::rowType (uint8_t row) {
+  return ((row * AG_ROW_TYPES) / ROWS);
+}
+
+/*
+ * Rub out whatever has changed since the grid was last drawn
+ * Returns true if the whole grid area was cleared
+ */
+template <uint8_t ROWS, uint8_t COLS>
+boolean AlienGridT<ROWS, COLS>::erase (SSD1306 &screen) {
+  if (drawn_y == AG_OFF_SCREEN) return (false);
+  if (drawn_x != grid_x || drawn_y != grid_y) {
+    // It's stepped, so the whole grid goes
+    screen.clearRect (drawn_x, drawn_y, drawnCols * AG_COLWIDTH, drawnRows * AG_ROWHEIGHT);
+    return (true);
+  }
+  if (drawnBangCol != bang_col || drawnBangRow != bang_row) {
+    // An alien has been shot - remove the old explosion and the alien
+    if (drawnBangCol != -1) clearCell (screen, drawnBangCol, drawnBangRow);
+    if (bang_col != -1) clearCell (screen, bang_col, bang_row);
+  }
+  return (false);
+}
+
+/*
+ * Draw the grid as it is now
+ */
+template <uint8_t ROWS, uint8_t COLS>
+void AlienGridT<ROWS, COLS>::show (SSD1306 &screen) {
+  if (drawn_y == AG_OFF_SCREEN || drawn_x != grid_x || drawn_y != grid_y) {
+    draw (screen);
+  } else if (drawnBangCol != bang_col || drawnBangRow != bang_row) {
+    if (bang_col != -1) {
+      screen.drawSprite (BM_EXPLOSION, grid_x + (bang_col * AG_COLWIDTH), grid_y + (bang_row * AG_ROWHEIGHT));
+    }
+  } else {
+    return;
   }
+  drawn_x = grid_x;
+  drawn_y = grid_y;
+  drawnCols = cols;
+  drawnRows = rows;
+  drawnBangCol = bang_col;
+  drawnBangRow = bang_row;
 }
+
+/*
+ * The screen has been cleared
+ */
+template <uint8_t ROWS, uint8_t COLS>
+void AlienGridT<ROWS, COLS>::offScreen () {
+  drawn_y = AG_OFF_SCREEN;
+}
+
+/*
+ * Rub out a single cell of the grid
+ */
+template <uint8_t ROWS, uint8_t COLS>
+void AlienGridT<ROWS, COLS>::clearCell (SSD1306 &screen, int8_t col, int8_t row) {
+  screen.clearRect (grid_x + (col * AG_COLWIDTH), grid_y + (row * AG_ROWHEIGHT), AG_COLWIDTH, AG_ROWHEIGHT);
+}
+
+/*
+ * The grid sizes in use. A different sized formation needs adding here.
+ */
+template class AlienGridT<AG_ROWS, AG_COLS>;
+#ifdef HAL_HOST
+// 32 and 64 bit rows, so they get built and checked (see bench/alien_grid_check.cpp)
+template class AlienGridT<5, 24>;
+template class AlienGridT<6, 40>;
+#endif
@@ -12,55 +12,119 @@
 #define alien_grid_h
 #include "SSD1306.h"
 #include "bitmaps.h"
+#include "rng.h"
 #include <Arduino.h>
 
 #define AG_COLWIDTH 9       // The alien grid column width in pixels
 #define AG_ROWHEIGHT 6      // ... row height in pixels
 #define AG_ROWS 5           // The initial number of rows
 #define AG_COLS 11          // ... and columns
-#define AG_START_X 9        // starting x coordinate 
+#define AG_START_X 9        // starting x coordinate
+#define AG_NO_ALIEN 0xFF    // Marks an empty column in the lowest alien table
+#define AG_ROW_TYPES 5      // The number of entries in the row tables at the bottom of this file
+#define AG_OFF_SCREEN 0xFF  // The grid hasn't been drawn
 
-class AlienGrid {
+/*
+ * Each row of the grid is a bitfield, one bit per column. The narrowest
+ * integer that will hold all of the columns is used, so the standard 11
+ * column grid is still 16 bits per row on the Arduino.
+ */
+template <uint8_t COLS, bool SMALL = (COLS <= 16), bool MEDIUM = (COLS <= 32)>
+struct AlienBits {
+  typedef uint64_t type;
+};
+template <uint8_t COLS>
+struct AlienBits<COLS, true, true> {
+  typedef uint16_t type;
+};
+template <uint8_t COLS>
+struct AlienBits<COLS, false, true> {
+  typedef uint32_t type;
+};
+
+/*
+ * Bit scanning for each width of bitfield, using the compiler's built in
+ * functions (which know the fastest way to do it on each processor)
+ */
+inline uint8_t agLowBit (uint16_t b) { return (__builtin_ctz (b)); }      // Position of the lowest set bit
+inline uint8_t agLowBit (uint32_t b) { return (__builtin_ctzl (b)); }
+inline uint8_t agLowBit (uint64_t b) { return (__builtin_ctzll (b)); }
+inline uint8_t agWidth (uint16_t b) { return ((sizeof (unsigned int) * 8) - __builtin_clz (b)); }  // Position of the highest set bit + 1
+inline uint8_t agWidth (uint32_t b) { return ((sizeof (unsigned long) * 8) - __builtin_clzl (b)); }
+inline uint8_t agWidth (uint64_t b) { return (64 - __builtin_clzll (b)); }
+inline uint8_t agBitCount (uint16_t b) { return (__builtin_popcount (b)); } // Number of set bits
+inline uint8_t agBitCount (uint32_t b) { return (__builtin_popcountl (b)); }
+inline uint8_t agBitCount (uint64_t b) { return (__builtin_popcountll (b)); }
+
+/*
+ * The alien grid, for any size of formation up to 64 columns.
+ * Screen coordinates are still 8 bit, so the formation has to fit on the
+ * screen for the drawing and collision detection to make sense.
+ */
+template <uint8_t ROWS, uint8_t COLS>
+class AlienGridT {
   public:
+    typedef typename AlienBits<COLS>::type Bits;
+
     void init (uint8_t start_y);        // Initialise the grid
     void draw (SSD1306 &screen);        // Draw the aliens into the screen buffer
-    void step (SSD1306 &screen);        // Move the grid one step left or right
-    int collisionDetect (SSD1306 &screen, uint8_t x, uint8_t y);    // Test the provided coordinate for collisions
+    void step ();                       // Move the grid one step left or right
+    int collisionDetect (uint8_t x, uint8_t y);    // Test the provided coordinate for collisions
     uint8_t getTop ();                  // Get the top coordinate of the grid
     uint8_t getBottom ();               // ... the bottom coordinate
     uint8_t getLeft ();                 // ... the left coordinate
     uint8_t getRight ();                // ... and the right
-    void clearArea (SSD1306 &screen);   // clear the grid area in the screen buffer
-    void clearExplosion ();             // clear the explosion graphic from the screen buffer
+    void clearExplosion ();             // clear the explosion graphic on the next step
     uint8_t getAlienCount ();           // count the remaining aliens
     uint8_t getCols ();                 // get the number of columns of aliens remaining
     uint8_t getColX (uint8_t);          // get the x coordinate of the specified column
     uint8_t getColY (uint8_t);          // ... and the y coordinate
     uint8_t getRandomColumn ();         // Choose a random column from those remaining
     boolean explosionPresent ();        // Check if the explosion graphic is still displayed
-    
+    boolean erase (SSD1306 &screen);    // Rub out whatever has changed since the grid was last drawn - returns true if it all went
+    void show (SSD1306 &screen);        // ... and draw it as it is now
+    void offScreen ();                  // The screen has been cleared, so draw it from scratch next time
+
   private:
+    static_assert (COLS > 0 && COLS <= 64, "The alien grid can have up to 64 columns");
+    static_assert (ROWS > 0 && ROWS < AG_NO_ALIEN, "Too many alien grid rows");
+    static_assert (ROWS * COLS <= 255, "The alien count must fit in a byte");
+
     void normaliseGrid ();              // Shift the alien grid bits to their left most (least significant) position
-    uint16_t grid[AG_ROWS];
-    uint8_t grid_x; 
+    static uint8_t rowType (uint8_t row); // Which entry in the row tables is used for a row
+    void clearCell (SSD1306 &screen, int8_t col, int8_t row); // Rub out one alien (or explosion)
+    Bits grid[ROWS];
+    Bits colMask;                       // All of the rows ORed together (a bit is set for each column with aliens in it)
+    uint8_t colBottom[COLS];            // The lowest row with an alien in it for each column (AG_NO_ALIEN if empty)
+    uint8_t grid_x;
     uint8_t grid_y;
-    uint8_t cols;              
+    uint8_t cols;
     uint8_t rows;
     boolean movingRight;                // True if the grid is moving right, false = left
     boolean removeExplosion;            // A flag used to decide if an explosion needs to be removed
     int8_t bang_col;                    // Explosion grid column number (-1 if no explosion is present)
     int8_t bang_row;                    // ... row
     uint8_t alienCount;
+    // What's on the screen
+    uint8_t drawn_x;
+    uint8_t drawn_y;                    // AG_OFF_SCREEN if not drawn
+    uint8_t drawnCols;
+    uint8_t drawnRows;
+    int8_t drawnBangCol;
+    int8_t drawnBangRow;
 };
 
+// The standard Space Invaders formation
+typedef AlienGridT<AG_ROWS, AG_COLS> AlienGrid;
+
 /*
  * An array to hold the pointers to the bitmaps
- * There are 5 rows, corresponding to the rows in the grid. If you wish to
- * increase the number of rows, this array will have to be extended.
+ * There are 5 row types, which are spread evenly over the rows in the grid.
+ * With the standard 5 row grid, that's one each.
  * The two columns in the array correspond to the bitmaps used as the aliens
  * "walk" across the screen.
  */
-const uint8_t alienBitmap[][2] PROGMEM = {
+const uint8_t alienBitmap[AG_ROW_TYPES][2] PROGMEM = {
   { BM_ALIEN30_1, BM_ALIEN30_2 },
   { BM_ALIEN20_1, BM_ALIEN20_2 },
   { BM_ALIEN20_1, BM_ALIEN20_2 },
@@ -69,10 +133,10 @@ const uint8_t alienBitmap[][2] PROGMEM = {
 };
 
 // The score values of each row of aliens (score values are in multiples of 10)
-const uint8_t alienScore[] PROGMEM = { 3, 2, 2, 1, 1 };
+const uint8_t alienScore[AG_ROW_TYPES] PROGMEM = { 3, 2, 2, 1, 1 };
 
 // For collision detection (aliens get thinner as you go up the grid)
-const uint8_t alienBounds[][2] PROGMEM = {
+const uint8_t alienBounds[AG_ROW_TYPES][2] PROGMEM = {
   { 1, 5 }, { 0, 6 }, { 0, 6 }, { 0, 7 }, { 0, 7 }
 };
 #endif
@@ -9,6 +9,7 @@
 *                                                                              *
 *******************************************************************************/
 #include "base.h"
+#include "trace.h"
 
 /*
  * Set the base to its starting position
@@ -21,15 +22,13 @@ void Base::init () {
 /*
  * Move the base if either the left or right button is pressed
  */
-boolean Base::moveBase (SSD1306 &screen, boolean left, boolean right) {
+boolean Base::moveBase (boolean left, boolean right) {
   if (!dead) {
     uint8_t pos = base_x;
     if (left && pos > 0) pos --;
     if (right && pos < 119) pos ++;
     if (pos != base_x) {
-      screen.clearRect (base_x, BASE_Y, 9, 5);
       base_x = pos;
-      drawBase (screen);
       return (true);
     }
   }
@@ -40,28 +39,22 @@ boolean Base::moveBase (SSD1306 &screen, boolean left, boolean right) {
  * Destroy the base - the base has been hit
  * Returns true is the base was destroyed (ie. was alive when hit)
  */
-boolean Base::destroyBase (SSD1306 &screen) {
+boolean Base::destroyBase () {
   if (!dead) {
     dead = true;
-    clearBase (screen);
-    drawBase (screen);
     return (true);
   }
   return (false);
 }
 
-void Base::clearBase (SSD1306 &screen) {
-  screen.clearRect (base_x, BASE_Y, 9, 5);
-}
-
 /*
  * Draw the base
  */
 void Base::drawBase (SSD1306 &screen) {
   if (dead) {
-    screen.drawBitmap (BM_BASE_DEAD, base_x, BASE_Y);    
+    screen.drawSprite (BM_BASE_DEAD, base_x, BASE_Y);    
   } else {
-    screen.drawBitmap (BM_BASE, base_x, BASE_Y);
+    screen.drawSprite (BM_BASE, base_x, BASE_Y);
   }
 }
 
@@ -70,7 +63,7 @@ void Base::drawBase (SSD1306 &screen) {
  * Only allows one laser to be active at any one time
  * Returns true if a laser was fired
  */
-boolean Base::fire (SSD1306 &screen, boolean trigger) {
+boolean Base::fire (boolean trigger) {
   // was the trigger pressed
   if (trigger) {
     // Is there no laser currely active and the bas is not dead?
@@ -80,7 +73,6 @@ boolean Base::fire (SSD1306 &screen, boolean trigger) {
         laser_y = LASER_START;
         laser_x = base_x + 4;
         fireButtonReleased = false;
-        drawLaser (screen);
         return (true);
       }
     }
@@ -95,14 +87,10 @@ boolean Base::fire (SSD1306 &screen, boolean trigger) {
 /*
  * Moves a laser, if one exists
  * Returns true if a laser was moved
- * 
- * Note - this function will clear the space left by a laser moving, but will not redraw it.
  */
-boolean Base::moveLaser (SSD1306 &screen) {
+boolean Base::moveLaser () {
   // If a laser exists
   if (laser_y) {
-    // Clear the screen where it was
-    screen.clearRect (laser_x, laser_y, 1, min (4, 59 - laser_y));
     // Move the laser up one pixel
     laser_y --;
     // Did the laser travel off the top of the screen?
@@ -118,11 +106,12 @@ boolean Base::moveLaser (SSD1306 &screen) {
 /*
  * Perform collision detection
  */
-boolean Base::collisionDetect (SSD1306 &screen, uint8_t x, uint8_t y) {
+boolean Base::collisionDetect (uint8_t x, uint8_t y) {
+  TRACE_SCOPE (TRACE_BASE_COLLISION);
   if (y > (BASE_Y + 2)) {
     if (x >= base_x && x <= (base_x + 9)) {
       // Boom!
-      return (destroyBase (screen));
+      return (destroyBase ());
     }
   }
   return (false);
@@ -134,7 +123,7 @@ boolean Base::collisionDetect (SSD1306 &screen, uint8_t x, uint8_t y) {
  */
 boolean Base::drawLaser (SSD1306 &screen) {
   if (laser_y) {
-    screen.drawBitmap (BM_LASER, laser_x, laser_y);
+    screen.drawSprite (BM_LASER, laser_x, laser_y);
     return (true);
   }
   return (false);
@@ -163,3 +152,42 @@ uint8_t Base::getLaserX () {
 boolean Base::isDead () {
   return (dead);
 }
+
+/*
+ * Rub out the base and laser where they were last drawn, if they've changed
+ */
+void Base::erase (SSD1306 &screen) {
+  if (drawn_x != BASE_OFF_SCREEN && (drawn_x != base_x || drawnDead != dead)) {
+    screen.clearRect (drawn_x, BASE_Y, 9, 5);
+  }
+  if (drawnLaser_y && (drawnLaser_y != laser_y || drawnLaser_x != laser_x)) {
+    // Stop short of the base
+    screen.clearRect (drawnLaser_x, drawnLaser_y, 1, min (4, 59 - drawnLaser_y));
+  }
+}
+
+/*
+ * Draw the base and laser where they are now, if they've changed
+ */
+void Base::show (SSD1306 &screen) {
+  if (drawn_x != base_x || drawnDead != dead) {
+    drawBase (screen);
+    if (drawn_x != BASE_OFF_SCREEN && drawn_x != base_x) LATENCY_DRAWN (LATENCY_MOVE, BASE_Y);
+    drawn_x = base_x;
+    drawnDead = dead;
+  }
+  if (drawnLaser_y != laser_y || drawnLaser_x != laser_x) {
+    drawLaser (screen);
+    if (laser_y == LASER_START) LATENCY_DRAWN (LATENCY_FIRE, laser_y);
+    drawnLaser_x = laser_x;
+    drawnLaser_y = laser_y;
+  }
+}
+
+/*
+ * The screen has been cleared
+ */
+void Base::offScreen () {
+  drawn_x = BASE_OFF_SCREEN;
+  drawnLaser_y = 0;
+}
@@ -13,9 +13,11 @@
 
 #include "SSD1306.h"
 #include "bitmaps.h"
+#include "latency.h"
 
 #define BASE_Y 59
 #define BASE_START_X 0
+#define BASE_OFF_SCREEN 0xFF // The base hasn't been drawn
 #define LASER_START 59
 #define POWER_LASER 2 // The power value of a laser hit
 
@@ -25,23 +27,19 @@ class Base {
     // Positions the base at the left side of the screen
     void init ();
     // Moves the base if the navigation buttons are pressed - returns true it it moved
-    boolean moveBase (SSD1306 &screen, boolean left, boolean right);
+    boolean moveBase (boolean left, boolean right);
     // Fires a laser if the trigger is pressed and no laser already exists - returns true if a laser was released
-    boolean fire (SSD1306 &screen, boolean trigger);
+    boolean fire (boolean trigger);
     // draws the base
     void drawBase (SSD1306&);
-    // clears the area where the base currently resides
-    void clearBase (SSD1306&);
     // perform a collision detection at the coordinates provided - returns true if hit
-    boolean collisionDetect (SSD1306 &screen, uint8_t x, uint8_t y);
+    boolean collisionDetect (uint8_t x, uint8_t y);
     // Check if the bas is dead
     boolean isDead ();
     // Laser stuff
     
     // Moves the laser if one exists - returns true if the laser was moved
-    boolean moveLaser (SSD1306&);
-    // Clears the space where the laser currently resides
-    void clearLaser (SSD1306&);
+    boolean moveLaser ();
     // Get laser Y - if 0, no laser exists
     uint8_t getLaserY ();
     // Get missule X - will get the last X value regardless of whether a laser exists or not
@@ -49,16 +47,28 @@ class Base {
     // Draw the laser - return true if the laser was drawn
     boolean drawLaser (SSD1306&);
     // Destroy the base
-    boolean destroyBase (SSD1306 &screen);
+    boolean destroyBase ();
     // Removes the laser
     void destroyLaser ();
-    uint8_t base_x;
+
+    // Bringing the screen up to date
+    // Rubs out the base and laser where they were last drawn, if they've changed
+    void erase (SSD1306&);
+    // ... and draws them where they are now
+    void show (SSD1306&);
+    // The screen has been cleared, so draw them from scratch next time
+    void offScreen ();
     
   private:
-//    uint8_t base_x;
+    uint8_t base_x;
     uint8_t laser_x;
     uint8_t laser_y; // Zero if no laser is currently active
     boolean fireButtonReleased;
     boolean dead;
+    // What's on the screen
+    uint8_t drawn_x; // BASE_OFF_SCREEN if not drawn
+    boolean drawnDead;
+    uint8_t drawnLaser_x;
+    uint8_t drawnLaser_y; // Zero if no laser drawn
 };
 #endif
@@ -0,0 +1,132 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * Checks for the bigger alien grids
+ * The game only uses the standard 11 column grid, which fits in 16 bit
+ * rows, so nothing else would build or run the 32 and 64 bit ones. This
+ * steps each size of grid, shoots out its left hand column the way the
+ * laser does, then its right hand column, and checks that the grid shrinks
+ * and moves as it should. Prints a line for each grid:
+ *   CHECK <rows>x<cols> ok
+ * or what went wrong, and exits with 1 if anything did.
+ *
+ * Build it like the benchmarks (see bench.cpp), from the sketch folder:
+ *   mkdir -p build
+ *   g++ -O2 -DHAL_HOST -Ihost -I. bench/alien_grid_check.cpp *.cpp host/core.cpp -o build/alien_grid_check
+ *   build/alien_grid_check
+ *
+ * Screen coordinates are 8 bit, so over 27 columns the right hand side of
+ * the grid is out of reach of the laser. Those aliens are removed directly,
+ * the way collisionDetect () would.
+ * The 24 and 40 column grids are built in alien_grid.cpp (host only).
+ */
+#include <stdio.h>
+// The checks need to get at the grid's insides
+#define private public
+#include "../alien_grid.h"
+#undef private
+
+static int failures;
+
+static void expect (bool ok, const char *grid, const char *what) {
+  if (!ok) {
+    printf ("CHECK %s FAILED %s\n", grid, what);
+    failures ++;
+  }
+}
+
+/*
+ * Shoot the lowest alien in a column, as the laser would if the column's
+ * in reach, otherwise take it out directly
+ * Returns true if there was one to hit
+ */
+template <uint8_t ROWS, uint8_t COLS>
+static bool shoot (AlienGridT<ROWS, COLS> &g, uint8_t col) {
+  uint8_t row = g.colBottom[col];
+  if (row == AG_NO_ALIEN) return (false);
+  if (g.grid_x + ((col + 1) * AG_COLWIDTH) <= 255) {
+    return (g.collisionDetect (g.getColX (col), g.getColY (col) - (AG_ROWHEIGHT / 2)) > 0);
+  }
+  typename AlienGridT<ROWS, COLS>::Bits bit = (typename AlienGridT<ROWS, COLS>::Bits)1 << col;
+  g.grid[row] = g.grid[row] & ~bit;
+  g.alienCount --;
+  while (row && !(g.grid[row - 1] & bit)) row --;
+  if (row == 0) {
+    g.colBottom[col] = AG_NO_ALIEN;
+    g.colMask = g.colMask & ~bit;
+  } else {
+    g.colBottom[col] = row - 1;
+  }
+  g.bang_col = col;
+  g.bang_row = g.colBottom[col] == AG_NO_ALIEN ? 0 : g.colBottom[col] + 1;
+  return (true);
+}
+
+template <uint8_t ROWS, uint8_t COLS>
+static void check () {
+  char name[8];
+  snprintf (name, sizeof (name), "%dx%d", ROWS, COLS);
+  int before = failures;
+  AlienGridT<ROWS, COLS> g;
+  g.init (8);
+  expect (g.getAlienCount () == ROWS * COLS, name, "alien count");
+  expect (g.getCols () == COLS && agBitCount (g.colMask) == COLS, name, "columns");
+
+  // Step until it's turned round twice, staying on the screen
+  uint8_t top = g.getTop ();
+  for (int i = 0; i < 1000 && g.getTop () < top + 6; i ++) {
+    g.step ();
+    expect (g.getLeft () <= SSD1306_LCDWIDTH, name, "stepped off the left");
+  }
+  expect (g.getTop () == top + 6, name, "step down at the edges");
+
+  // Shoot out the left hand column, bottom up
+  for (uint8_t row = ROWS; row --; ) {
+    expect (shoot (g, 0), name, "hit left column");
+    expect (g.colBottom[0] == (row ? row - 1 : AG_NO_ALIEN), name, "left column bottom");
+  }
+  expect (!shoot (g, 0), name, "left column empty");
+  expect (!(g.colMask & 1), name, "left column mask");
+  // The grid closes up on the next step
+  uint8_t left = g.getLeft ();
+  g.clearExplosion ();
+  g.step ();
+  expect (g.getCols () == COLS - 1, name, "left column dropped");
+  expect (g.getLeft () == left + AG_COLWIDTH + (g.movingRight ? 1 : -1), name, "moved over a column");
+  expect ((g.colMask & 1) && agWidth (g.colMask) == COLS - 1, name, "mask normalised");
+  expect (g.colBottom[0] == ROWS - 1 && g.colBottom[COLS - 1] == AG_NO_ALIEN, name, "column bottoms normalised");
+
+  // Then the right hand column
+  uint8_t right = g.getCols () - 1;
+  while (shoot (g, right)) ;
+  g.clearExplosion ();
+  g.step ();
+  expect (g.getCols () == COLS - 2, name, "right column dropped");
+  expect (agWidth (g.colMask) == COLS - 2, name, "right column mask");
+  expect (g.getAlienCount () == ROWS * (COLS - 2), name, "aliens left");
+
+  // Bombs only come from columns with aliens in
+  for (int i = 0; i < 1000; i ++) {
+    uint8_t col = g.getRandomColumn ();
+    if (col >= g.getCols () || g.colBottom[col] == AG_NO_ALIEN) {
+      expect (false, name, "bomb from an empty column");
+      break;
+    }
+  }
+  if (failures == before) printf ("CHECK %s ok\n", name);
+}
+
+int main () {
+  check<AG_ROWS, AG_COLS> ();
+  check<5, 24> ();
+  check<6, 40> ();
+  return (failures ? 1 : 0);
+}
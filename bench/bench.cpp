@@ -0,0 +1,227 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * Microbenchmarks for the drawing and collision detection
+ * Times the small things that get called over and over, on the host, so
+ * that changes to them can be measured rather than guessed at. Each one is
+ * run several times and the fastest is kept, which irons out most of the
+ * noise from the PC doing other things.
+ * The results are printed one per line:
+ *   BENCH <name> <nanoseconds per call>
+ * and checked against a baseline by tools/bench.py, which fails if anything
+ * has got slower.
+ *
+ * Build it with the host backend (see hal.h), all the sketch's .cpp files
+ * (not the .ino) and the host's Arduino core (but not host/main.cpp), from
+ * the sketch folder:
+ *   mkdir -p build
+ *   g++ -O2 -DHAL_HOST -Ihost -I. bench/bench.cpp *.cpp host/core.cpp -o build/invaders_bench
+ * The baseline is for your machine, so save one before changing anything
+ * (three runs, as the fastest of each counts):
+ *   for i in 1 2 3; do build/invaders_bench; done | tools/bench.py - --update
+ * then after the change, rebuild and check against it:
+ *   for i in 1 2 3; do build/invaders_bench; done | tools/bench.py -
+ *
+ * The numbers are for the PC, not the Arduino, so they only mean anything
+ * compared with each other, on the same machine. The sends include the
+ * host backend and the stand-in display (host_panel.cpp), so they're only
+ * good for spotting changes in how much is sent.
+ * Buffer mode only - in strip mode the drawing goes into the display list.
+ */
+#include <stdio.h>
+#include <chrono>
+// The benchmarks need to get at the driver's insides
+#define private public
+#include "../SSD1306.h"
+#include "../alien_grid.h"
+#include "../defence.h"
+#undef private
+
+#ifdef SSD1306_STRIP
+#error The benchmarks are for buffer mode
+#endif
+
+#define BENCH_REPEATS 15            // Runs of each benchmark (the fastest counts)
+#define BENCH_CALLS 200000          // Calls in each run (roughly)
+#define BENCH_WARM_UP 3             // Untimed runs first (to get the cache and clock speed up)
+
+SSD1306 screen(-1);
+
+/*
+ * Time a benchmark and print the result
+ * The function makes as many calls as it likes, and returns how many.
+ */
+static void bench (const char *name, unsigned long (*run) ()) {
+  double best = 0;
+  for (uint8_t i = 0; i < BENCH_WARM_UP; i ++) run ();
+  for (uint8_t i = 0; i < BENCH_REPEATS; i ++) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    unsigned long calls = run ();
+    double ns = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count () / calls;
+    if (i == 0 || ns < best) best = ns;
+  }
+  printf ("BENCH %s %.1f\n", name, best);
+}
+
+/*
+ * Drawing
+ * The same bitmap at each of the 8 positions within a page (5 and above
+ * spill into the next page).
+ */
+static uint8_t shift;
+
+static unsigned long drawBitmap () {
+  screen.clear ();
+  for (unsigned long i = 0; i < BENCH_CALLS; i ++) {
+    screen.drawBitmap (BM_ALIEN20_1, 60, 24 + shift);
+  }
+  return (BENCH_CALLS);
+}
+
+/*
+ * Clearing rectangles, from a bit of one page up to the whole screen
+ */
+static uint8_t rect[4];             // x, y, w, h
+
+static unsigned long clearRect () {
+  for (unsigned long i = 0; i < BENCH_CALLS; i ++) {
+    screen.clearRect (rect[0], rect[1], rect[2], rect[3]);
+  }
+  return (BENCH_CALLS);
+}
+
+static unsigned long setUpdateArea () {
+  for (unsigned long i = 0; i < BENCH_CALLS; i ++) {
+    screen.setUpdateArea (i & 7, i & 0x3F, (i & 0x3F) + 9);
+  }
+  return (BENCH_CALLS);
+}
+
+/*
+ * Sending part of a page, and a whole one
+ */
+static uint8_t sendWidth;
+
+static unsigned long send () {
+  unsigned long calls = BENCH_CALLS / 10;
+  for (unsigned long i = 0; i < calls; i ++) {
+    OLED_TRANSPORT::data (screen.buffer[3], sendWidth);
+  }
+  return (calls);
+}
+
+/*
+ * Collision detection
+ * A laser goes up the screen (or a bomb down) a pixel at a time, as in the
+ * game, at each x position in turn. The grid or defence is put back after
+ * each one, so the hits are the same every time.
+ */
+static AlienGrid fullGrid, sparseGrid;
+static AlienGrid grid;
+static Defence fullDefence;
+static Defence defence;
+
+static unsigned long alienCollision () {
+  unsigned long calls = 0;
+  while (calls < BENCH_CALLS) {
+    for (uint8_t x = 0; x < SSD1306_LCDWIDTH; x ++) {
+      AlienGrid g = grid;
+      for (uint8_t y = 58; y > 5; y --) {
+        g.collisionDetect (x, y);
+        calls ++;
+      }
+    }
+  }
+  return (calls);
+}
+
+static unsigned long defenceCollision () {
+  unsigned long calls = 0;
+  while (calls < BENCH_CALLS) {
+    effectsRandom.seed (RNG_SEED_EFFECTS);
+    for (uint8_t x = 10; x < 50; x ++) {
+      Defence d = defence;
+      for (uint8_t y = 40; y < 64; y ++) {
+        d.collisionDetect (x, y, 30, 2);
+        calls ++;
+      }
+    }
+  }
+  return (calls);
+}
+
+/*
+ * A step, with an explosion to clear (which tidies up the grid)
+ */
+static unsigned long alienStep () {
+  for (unsigned long i = 0; i < BENCH_CALLS; i ++) {
+    AlienGrid g = grid;
+    g.step ();
+  }
+  return (BENCH_CALLS);
+}
+
+int main () {
+  char name[40];
+  screen.init ();
+
+  for (shift = 0; shift < 8; shift ++) {
+    sprintf (name, "drawBitmap/shift%u", shift);
+    bench (name, drawBitmap);
+  }
+
+  static const struct {
+    const char *name;
+    uint8_t rect[4];
+  } rects[] = {
+    { "clearRect/1page", { 60, 17, 9, 5 } },
+    { "clearRect/2pages", { 60, 22, 9, 5 } },
+    { "clearRect/3pages", { 60, 12, 9, 14 } },
+    { "clearRect/line", { 0, 6, 128, 5 } },
+    { "clearRect/screen", { 0, 0, 128, 64 } }
+  };
+  for (uint8_t i = 0; i < sizeof (rects) / sizeof (rects[0]); i ++) {
+    memcpy (rect, rects[i].rect, sizeof (rect));
+    bench (rects[i].name, clearRect);
+  }
+
+  bench ("setUpdateArea", setUpdateArea);
+
+  sendWidth = 16;
+  bench ("send/16", send);
+  sendWidth = SSD1306_LCDWIDTH;
+  bench ("send/page", send);
+
+  // A full grid, and one with three aliens in four shot
+  fullGrid.init (8);
+  sparseGrid.init (8);
+  for (uint8_t row = 0; row < AG_ROWS; row ++) {
+    for (uint8_t col = 0; col < AG_COLS; col ++) {
+      if ((row + col) % 4) sparseGrid.collisionDetect (AG_START_X + (col * AG_COLWIDTH) + 4, 8 + (row * AG_ROWHEIGHT) + 2);
+    }
+  }
+  grid = fullGrid;
+  bench ("alienCollision/full", alienCollision);
+  grid = sparseGrid;
+  bench ("alienCollision/sparse", alienCollision);
+
+  fullDefence.init (15);
+  defence = fullDefence;
+  bench ("defenceCollision", defenceCollision);
+
+  grid = fullGrid;
+  grid.clearExplosion ();
+  bench ("alienStep/full", alienStep);
+  grid = sparseGrid;
+  grid.clearExplosion ();
+  bench ("alienStep/sparse", alienStep);
+  return (0);
+}
@@ -0,0 +1,565 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * Generated by tools/assets.py from assets/bitmaps.txt - edit those, not this
+ */
+#ifndef bitmap_data_h
+#define bitmap_data_h
+
+#if !defined (BITMAPS_PLAIN)
+#define BM_EXCLAIM 0
+#define BM_STAR 3
+#define BM_HYPHEN 6
+#define BM_DOT 8
+#define BM_0 11
+#define BM_1 14
+#define BM_2 17
+#define BM_3 20
+#define BM_4 23
+#define BM_5 26
+#define BM_6 29
+#define BM_7 32
+#define BM_8 35
+#define BM_9 38
+#define BM_EQUALS 41
+#define BM_QUESTION 43
+#define BM_A 47
+#define BM_B 50
+#define BM_C 53
+#define BM_D 56
+#define BM_E 59
+#define BM_F 62
+#define BM_G 65
+#define BM_H 68
+#define BM_I 71
+#define BM_J 74
+#define BM_K 77
+#define BM_L 80
+#define BM_M 83
+#define BM_N 88
+#define BM_P 92
+#define BM_Q 95
+#define BM_R 98
+#define BM_S 101
+#define BM_T 104
+#define BM_U 107
+#define BM_V 110
+#define BM_W 113
+#define BM_X 118
+#define BM_Y 121
+#define BM_Z 124
+#define BM_INVERTED_Y 127
+#define BM_BACK 130
+#define BM_MYSTERY 133
+#define BM_ALIEN30_1 142
+#define BM_ALIEN30_2 147
+#define BM_ALIEN20_1 152
+#define BM_ALIEN20_2 159
+#define BM_ALIEN10_1 166
+#define BM_ALIEN10_2 174
+#define BM_BASE 182
+#define BM_BASE_DEAD 189
+#define BM_DEFENCE 198
+#define BM_EXPLOSION 210
+#define BM_LASER 217
+#define BM_BOMB_1_1 218
+#define BM_BOMB_1_2 220
+#define BM_BOMB_2_1 222
+#define BM_BOMB_2_2 225
+#define BM_BOX_TOP 228
+#define BM_BOX_SIDE 232
+#define BM_BOX_BOTTOM 233
+#define BM_TITLE01 237
+#define BM_TITLE02 281
+#define BM_TITLE03 316
+#define BM_TITLE04 359
+#define BM_TITLE05 404
+#define BM_TITLE06 449
+#define BM_TITLE07 513
+#define BM_TITLE08 586
+#define BM_TITLE09 667
+#define BM_TITLE10 740
+#define BM_TITLE11 820
+#define BM_SIZE 861
+
+const uint8_t bitmaps[] PROGMEM = {
+  B00000000, B00011101, B10000000, // !
+  B00001010, B00011111, B10001010, // *
+  B00000100, B11000001, // -
+  B00000000, B00010000, B10000000, // .
+  B00001110, B00010001, B10001110, // 0
+  B00010010, B00011111, B10010000, // 1
+  B00011001, B00010101, B10010010, // 2
+  B00010101, B00010101, B10001010, // 3
+  B00001111, B00001000, B10011100, // 4
+  B00010111, B00010101, B10001001, // 5
+  B00001110, B00010101, B10001001, // 6
+  B00000001, B00011101, B10000011, // 7
+  B00001010, B00010101, B10001010, // 8
+  B00010010, B00010101, B10001110, // 9
+  B00001010, B11000001, // =
+  B00000010, B00000001, B00010101, B10000010, // ?
+  B00011110, B00000101, B10011110, // A
+  B00011111, B00010101, B10001010, // B
+  B00001110, B00010001, B10001010, // C
+  B00011111, B00010001, B10001110, // D
+  B00011111, B00010101, B10010001, // E
+  B00011111, B00000101, B10000001, // F
+  B00001110, B00010001, B10011010, // G
+  B00011111, B00000100, B10011111, // H
+  B00010001, B00011111, B10010001, // I
+  B00010001, B00011111, B10000001, // J
+  B00011111, B00000100, B10011011, // K
+  B00011111, B00010000, B10010000, // L
+  B00011111, B00000010, B00000100, B00000010, B10011111, // M
+  B00011111, B00000010, B00000100, B10011111, // N
+  B00011111, B00000101, B10000010, // P
+  B00001110, B00010001, B10011110, // Q
+  B00011111, B00000101, B10011010, // R
+  B00010010, B00010101, B10001001, // S
+  B00000001, B00011111, B10000001, // T
+  B00011111, B00010000, B10011111, // U
+  B00001111, B00010000, B10001111, // V
+  B00001111, B00010000, B00001110, B00010000, B10001111, // W
+  B00011011, B00000100, B10011011, // X
+  B00000011, B00011100, B10000011, // Y
+  B00011001, B00010101, B10010011, // Z
+  B00011000, B00000111, B10011000, // Inverted Y
+  B00000100, B00001110, B10011111, // Back symbol
+  B00001100, B00011010, B00001110, B00001011, B00011110, B00001011, B00001110, B00011010, B10001100, // Mystery ship
+  B00010100, B00001010, B00010111, B00001010, B10010100, // 30pt alien position 1
+  B00000100, B00011010, B00000111, B00011010, B10000100, // 30pt alien position 2
+  B00011000, B00001101, B00011010, B00001110, B00011010, B00001101, B10011000, // 20pt alien position 1
+  B00001100, B00011101, B00001010, B00001110, B00001010, B00011101, B10001100, // 20pt alien position 2
+  B00010110, B00011111, B00001101, B00000111, B00000111, B00001101, B00011111, B10010110, // 10pt alien position 1
+  B00001110, B00011111, B00010101, B00000111, B00000111, B00010101, B00011111, B10001110, // 10pt alien position 2
+  B00011000, B00011100, B01000001, B00011111, B00011100, B01000001, B10011000, // Base
+  B00010100, B00011001, B00011000, B00011100, B00011101, B00011000, B00011010, B00010001, B10010100, // Base destroyed
+  // Defence
+  B00011100, B00011110, B00011111, B00011111, B00001111, B00000111, B01000010, B00001111, B00011111, B00011111, B00011110,
+  B10011100,
+  B00000101, B00010010, B00001100, B00000001, B00000100, B00001010, B10010001, // Explosion
+  B10001111, // Laser
+  B00010101, B10001010, // Bomb 1 position 1
+  B00001010, B10010101, // Bomb 1 position 2
+  B00001000, B00011111, B10001000, // Bomb 2 position 1
+  B00000010, B00011111, B10000010, // Bomb 2 position 1
+  B00011000, B00001000, B01000101, B10011000, // Box top
+  B10011111, // Box side
+  B00000011, B00000010, B01000101, B10000011, // Box bottom
+  // Title row 1
+  B00010000, B00001000, B00001010, B00001001, B01000100, B00010001, B00000010, B00000100, B00001000, B00000000, B00000000,
+  B00011000, B00001011, B00001001, B01000110, B00010010, B00000100, B00001000, B00000000, B01000001, B00011000, B00001011,
+  B00001001, B01000011, B00001011, B00011000, B00000000, B01000010, B00001000, B00000100, B00010010, B00001001, B01000101,
+  B00001010, B00010000, B00000000, B01000001, B00000011, B00011001, B00001001, B01000110, B00001011, B00001000, B10011000,
+  // Title row 2
+  B00011000, B00011100, B00011110, B01000110, B00011100, B00011000, B00010001, B00000010, B00000000, B00000000, B00011110,
+  B01001000, B00011100, B00011000, B00010001, B00000110, B00000000, B01000001, B00011110, B01000111, B00000000, B01000010,
+  B00000110, B00010001, B00011000, B00011100, B00011110, B01000110, B00011100, B00011000, B00000000, B01000001, B00011110,
+  B01001010, B10001110,
+  // Title row 3
+  B00000011, B00001111, B00011111, B01000010, B00011101, B00000001, B00000111, B00001111, B01000011, B00000000, B00000000,
+  B00000011, B00011111, B01000011, B00000000, B00000001, B00011111, B01000100, B00000000, B00000000, B00011000, B00011111,
+  B01000010, B00001111, B00011111, B01000010, B00011000, B00000000, B01000010, B00011111, B01000011, B00000001, B00000000,
+  B00001111, B01000100, B00000000, B00000000, B00011111, B01000011, B00000111, B00000001, B00000100, B10001100,
+  // Title row 4
+  B00000011, B00000111, B00001111, B00011111, B00011111, B00011110, B00011100, B01000011, B00011000, B00010010, B00000100,
+  B00000000, B00000011, B00011111, B01000010, B00011100, B00011000, B00011111, B01000011, B00001111, B00000000, B00000000,
+  B00011111, B01000011, B00000000, B00011111, B01000011, B00000000, B01000001, B00011000, B00011111, B01000010, B00000011,
+  B00000000, B00000100, B01000010, B00001100, B00000000, B00000000, B00010000, B00011111, B01000011, B00001111, B01000010,
+  B10000111,
+  // Title row 5
+  B00011000, B00011000, B00011001, B01000001, B00010001, B00000001, B00011111, B01000011, B00010000, B00000000, B00000011,
+  B00011111, B01000010, B00000011, B01000010, B00000001, B00000000, B01000001, B00011100, B00011111, B01000010, B00001111,
+  B00001110, B00001111, B00011111, B01000010, B00011100, B00000000, B00000000, B00011111, B01000011, B00010000, B00011000,
+  B00011111, B01000010, B00001111, B00000000, B00011000, B00011111, B01000011, B00010001, B00010000, B00010010, B00010110,
+  B10010000,
+  // Title row 6
+  B00001100, B00000100, B01000001, B00001100, B00000000, B00000100, B00001100, B00000100, B01000001, B00001000, B00000000,
+  B00001100, B00000100, B01000001, B00001100, B00000000, B00001000, B00000001, B00000011, B00000011, B00000111, B01000101,
+  B00000011, B00000001, B00001100, B00000000, B00000111, B01000011, B00000000, B00000100, B01000001, B00001100, B00000000,
+  B00000000, B00000111, B01000011, B00000000, B00000100, B00000000, B00000111, B01000011, B00000000, B00000000, B00000011,
+  B00000111, B01000110, B00000011, B00000001, B00000100, B00000000, B00000111, B01001000, B00000011, B00000000, B00000100,
+  B01000001, B00001000, B00000000, B01000010, B00010000, B00001000, B00000100, B01000110, B10001000,
+  // Title row 7
+  B00011000, B01000001, B00011011, B00011001, B00011001, B00000001, B00000001, B00001011, B00011000, B00011000, B00011001,
+  B00011011, B00010001, B00000001, B00000001, B00011010, B00011000, B00011011, B00011001, B01000001, B00000011, B00000000,
+  B00011000, B00011011, B00011001, B01000001, B00010001, B00000011, B00001100, B00010000, B00000000, B00011011, B00011001,
+  B01000010, B00000011, B00000000, B00000000, B00011011, B00011001, B01000101, B00011011, B00000000, B01000011, B00011011,
+  B00011001, B01001000, B00010010, B00000100, B00000000, B01000001, B00011011, B00011001, B01001000, B00011011, B00011000,
+  B00000000, B00000011, B00011001, B01001000, B00011010, B00011000, B00010000, B00000000, B00000100, B00000010, B00000010,
+  B00010001, B00010001, B00011001, B01000101, B00011010, B00011000, B10011000,
+  // Title row 8
+  B00000001, B00000111, B00001111, B00011111, B01000001, B00011110, B00011000, B00000001, B00000011, B00001111, B00011111,
+  B01000001, B00011110, B00011000, B00010011, B00000111, B00011111, B01000010, B00011100, B00000000, B00000011, B00001111,
+  B00011111, B01000001, B00011110, B00010000, B00000001, B00000000, B00001111, B00011111, B01000010, B00011000, B00000000,
+  B00000000, B00011111, B01000111, B00011110, B00000000, B01000010, B00011111, B01000100, B00000001, B00011111, B01000100,
+  B00000000, B00000000, B00011100, B00011111, B01000011, B00000011, B00000001, B00000101, B00000101, B00001101, B00000001,
+  B00011001, B00000000, B00011000, B00011110, B00011111, B01000010, B00000111, B00000001, B00011001, B00011111, B01000010,
+  B00001111, B00000011, B00010000, B00011100, B00011110, B00011111, B01000001, B00001111, B00000011, B00010001, B00011101,
+  B00011111, B01000010, B00000111, B10000001,
+  // Title row 9
+  B00000001, B00000011, B00001111, B00011111, B01000001, B00011110, B00011000, B00000001, B00000111, B00001111, B00011111,
+  B01001000, B00011000, B00000000, B00000001, B00000111, B00011111, B01000001, B00011110, B00011000, B00000000, B00000111,
+  B00011111, B01000010, B00000000, B00000000, B00000001, B00011111, B01000010, B00000001, B00001111, B00011111, B01000010,
+  B00010000, B00000000, B00000000, B00011111, B01000011, B00000111, B00000000, B00011111, B01000011, B00000011, B00000000,
+  B00011000, B00011111, B01000011, B00001111, B01000011, B00000011, B00000000, B00010000, B00011110, B00011111, B01000010,
+  B00001111, B00011100, B00011100, B00011111, B00011111, B00010011, B00000011, B00001011, B00001001, B00000000, B00000110,
+  B00001111, B00011111, B01000010, B00011101, B00011100, B01000001, B10011000,
+  // Title row 10
+  B00000011, B00000111, B00001111, B00011111, B00011111, B00011110, B00011000, B00000001, B00000111, B00011111, B01000001,
+  B00011110, B00011001, B00000011, B00000111, B00001111, B00011111, B00011111, B00011100, B00010000, B00000000, B00000011,
+  B00001111, B00011111, B01000001, B00011110, B00011111, B01000010, B00011110, B00000000, B00000000, B00011111, B01000010,
+  B00001110, B00000110, B00000111, B00011111, B01000010, B00011000, B00000000, B00011111, B01000011, B00011000, B00011000,
+  B00011111, B01000010, B00001111, B00000000, B00010000, B00011111, B01000011, B00011001, B00011000, B00011001, B00011001,
+  B00011011, B00000000, B00010000, B00011100, B00011111, B01000010, B00000011, B00010000, B00011100, B00011111, B01000001,
+  B00001111, B00000011, B00011000, B00011100, B00011110, B01000010, B00010010, B00011000, B00011100, B00011111, B00011111,
+  B00001111, B00000111, B10000011,
+  // Title row 11
+  B00000001, B01000011, B00000000, B00000000, B00000001, B01000011, B00000000, B00000000, B00000001, B01000010, B00000000,
+  B01000001, B00000001, B01000111, B00000000, B00000000, B00000001, B01000010, B00000000, B01000001, B00000001, B01000011,
+  B00000000, B00000001, B01001000, B00000000, B01000001, B00000001, B01001000, B00000000, B00000000, B00000001, B01000011,
+  B00000000, B00000000, B00000001, B01000011, B00000000, B01000001, B00000001, B11000110
+};
+
+#elif defined (BITMAPS_PLAIN)
+#define BM_EXCLAIM 0
+#define BM_STAR 3
+#define BM_HYPHEN 6
+#define BM_DOT 9
+#define BM_0 12
+#define BM_1 15
+#define BM_2 18
+#define BM_3 21
+#define BM_4 24
+#define BM_5 27
+#define BM_6 30
+#define BM_7 33
+#define BM_8 36
+#define BM_9 39
+#define BM_EQUALS 42
+#define BM_QUESTION 45
+#define BM_A 49
+#define BM_B 52
+#define BM_C 55
+#define BM_D 58
+#define BM_E 61
+#define BM_F 64
+#define BM_G 67
+#define BM_H 70
+#define BM_I 73
+#define BM_J 76
+#define BM_K 79
+#define BM_L 82
+#define BM_M 85
+#define BM_N 90
+#define BM_P 94
+#define BM_Q 97
+#define BM_R 100
+#define BM_S 103
+#define BM_T 106
+#define BM_U 109
+#define BM_V 112
+#define BM_W 115
+#define BM_X 120
+#define BM_Y 123
+#define BM_Z 126
+#define BM_INVERTED_Y 129
+#define BM_BACK 132
+#define BM_MYSTERY 135
+#define BM_ALIEN30_1 144
+#define BM_ALIEN30_2 149
+#define BM_ALIEN20_1 154
+#define BM_ALIEN20_2 161
+#define BM_ALIEN10_1 168
+#define BM_ALIEN10_2 176
+#define BM_BASE 184
+#define BM_BASE_DEAD 193
+#define BM_DEFENCE 202
+#define BM_EXPLOSION 216
+#define BM_LASER 223
+#define BM_BOMB_1_1 224
+#define BM_BOMB_1_2 226
+#define BM_BOMB_2_1 228
+#define BM_BOMB_2_2 231
+#define BM_BOX_TOP 234
+#define BM_BOX_SIDE 243
+#define BM_BOX_BOTTOM 244
+#define BM_TITLE01 253
+#define BM_TITLE02 325
+#define BM_TITLE03 401
+#define BM_TITLE04 472
+#define BM_TITLE05 541
+#define BM_TITLE06 607
+#define BM_TITLE07 712
+#define BM_TITLE08 828
+#define BM_TITLE09 943
+#define BM_TITLE10 1049
+#define BM_TITLE11 1150
+#define BM_SIZE 1243
+
+const uint8_t bitmaps[] PROGMEM = {
+  B00000000, B00011101, B10000000, // !
+  B00001010, B00011111, B10001010, // *
+  B00000100, B00000100, B10000100, // -
+  B00000000, B00010000, B10000000, // .
+  B00001110, B00010001, B10001110, // 0
+  B00010010, B00011111, B10010000, // 1
+  B00011001, B00010101, B10010010, // 2
+  B00010101, B00010101, B10001010, // 3
+  B00001111, B00001000, B10011100, // 4
+  B00010111, B00010101, B10001001, // 5
+  B00001110, B00010101, B10001001, // 6
+  B00000001, B00011101, B10000011, // 7
+  B00001010, B00010101, B10001010, // 8
+  B00010010, B00010101, B10001110, // 9
+  B00001010, B00001010, B10001010, // =
+  B00000010, B00000001, B00010101, B10000010, // ?
+  B00011110, B00000101, B10011110, // A
+  B00011111, B00010101, B10001010, // B
+  B00001110, B00010001, B10001010, // C
+  B00011111, B00010001, B10001110, // D
+  B00011111, B00010101, B10010001, // E
+  B00011111, B00000101, B10000001, // F
+  B00001110, B00010001, B10011010, // G
+  B00011111, B00000100, B10011111, // H
+  B00010001, B00011111, B10010001, // I
+  B00010001, B00011111, B10000001, // J
+  B00011111, B00000100, B10011011, // K
+  B00011111, B00010000, B10010000, // L
+  B00011111, B00000010, B00000100, B00000010, B10011111, // M
+  B00011111, B00000010, B00000100, B10011111, // N
+  B00011111, B00000101, B10000010, // P
+  B00001110, B00010001, B10011110, // Q
+  B00011111, B00000101, B10011010, // R
+  B00010010, B00010101, B10001001, // S
+  B00000001, B00011111, B10000001, // T
+  B00011111, B00010000, B10011111, // U
+  B00001111, B00010000, B10001111, // V
+  B00001111, B00010000, B00001110, B00010000, B10001111, // W
+  B00011011, B00000100, B10011011, // X
+  B00000011, B00011100, B10000011, // Y
+  B00011001, B00010101, B10010011, // Z
+  B00011000, B00000111, B10011000, // Inverted Y
+  B00000100, B00001110, B10011111, // Back symbol
+  B00001100, B00011010, B00001110, B00001011, B00011110, B00001011, B00001110, B00011010, B10001100, // Mystery ship
+  B00010100, B00001010, B00010111, B00001010, B10010100, // 30pt alien position 1
+  B00000100, B00011010, B00000111, B00011010, B10000100, // 30pt alien position 2
+  B00011000, B00001101, B00011010, B00001110, B00011010, B00001101, B10011000, // 20pt alien position 1
+  B00001100, B00011101, B00001010, B00001110, B00001010, B00011101, B10001100, // 20pt alien position 2
+  B00010110, B00011111, B00001101, B00000111, B00000111, B00001101, B00011111, B10010110, // 10pt alien position 1
+  B00001110, B00011111, B00010101, B00000111, B00000111, B00010101, B00011111, B10001110, // 10pt alien position 2
+  B00011000, B00011100, B00011100, B00011100, B00011111, B00011100, B00011100, B00011100, B10011000, // Base
+  B00010100, B00011001, B00011000, B00011100, B00011101, B00011000, B00011010, B00010001, B10010100, // Base destroyed
+  // Defence
+  B00011100, B00011110, B00011111, B00011111, B00001111, B00000111, B00000111, B00000111, B00000111, B00001111, B00011111,
+  B00011111, B00011110, B10011100,
+  B00000101, B00010010, B00001100, B00000001, B00000100, B00001010, B10010001, // Explosion
+  B10001111, // Laser
+  B00010101, B10001010, // Bomb 1 position 1
+  B00001010, B10010101, // Bomb 1 position 2
+  B00001000, B00011111, B10001000, // Bomb 2 position 1
+  B00000010, B00011111, B10000010, // Bomb 2 position 1
+  B00011000, B00001000, B00001000, B00001000, B00001000, B00001000, B00001000, B00001000, B10011000, // Box top
+  B10011111, // Box side
+  B00000011, B00000010, B00000010, B00000010, B00000010, B00000010, B00000010, B00000010, B10000011, // Box bottom
+  // Title row 1
+  B00010000, B00001000, B00001010, B00001001, B00001001, B00001001, B00001001, B00001001, B00001001, B00010001, B00000010,
+  B00000100, B00001000, B00000000, B00000000, B00011000, B00001011, B00001001, B00001001, B00001001, B00001001, B00001001,
+  B00001001, B00001001, B00001001, B00010010, B00000100, B00001000, B00000000, B00000000, B00000000, B00011000, B00001011,
+  B00001001, B00001001, B00001001, B00001001, B00001001, B00001011, B00011000, B00000000, B00000000, B00000000, B00000000,
+  B00001000, B00000100, B00010010, B00001001, B00001001, B00001001, B00001001, B00001001, B00001001, B00001001, B00001010,
+  B00010000, B00000000, B00000000, B00000000, B00000011, B00011001, B00001001, B00001001, B00001001, B00001001, B00001001,
+  B00001001, B00001001, B00001001, B00001011, B00001000, B10011000,
+  // Title row 2
+  B00011000, B00011100, B00011110, B00011110, B00011110, B00011110, B00011110, B00011110, B00011110, B00011110, B00011100,
+  B00011000, B00010001, B00000010, B00000000, B00000000, B00011110, B00011110, B00011110, B00011110, B00011110, B00011110,
+  B00011110, B00011110, B00011110, B00011110, B00011100, B00011000, B00010001, B00000110, B00000000, B00000000, B00000000,
+  B00011110, B00011110, B00011110, B00011110, B00011110, B00011110, B00011110, B00011110, B00011110, B00000000, B00000000,
+  B00000000, B00000000, B00000110, B00010001, B00011000, B00011100, B00011110, B00011110, B00011110, B00011110, B00011110,
+  B00011110, B00011110, B00011110, B00011100, B00011000, B00000000, B00000000, B00000000, B00011110, B00011110, B00011110,
+  B00011110, B00011110, B00011110, B00011110, B00011110, B00011110, B00011110, B00011110, B00011110, B10001110,
+  // Title row 3
+  B00000011, B00001111, B00011111, B00011111, B00011111, B00011111, B00011101, B00000001, B00000111, B00001111, B00001111,
+  B00001111, B00001111, B00001111, B00000000, B00000000, B00000011, B00011111, B00011111, B00011111, B00011111, B00011111,
+  B00000000, B00000001, B00011111, B00011111, B00011111, B00011111, B00011111, B00011111, B00000000, B00000000, B00011000,
+  B00011111, B00011111, B00011111, B00011111, B00001111, B00011111, B00011111, B00011111, B00011111, B00011000, B00000000,
+  B00000000, B00000000, B00000000, B00011111, B00011111, B00011111, B00011111, B00011111, B00000001, B00000000, B00001111,
+  B00001111, B00001111, B00001111, B00001111, B00001111, B00000000, B00000000, B00011111, B00011111, B00011111, B00011111,
+  B00011111, B00000111, B00000001, B00000100, B10001100,
+  // Title row 4
+  B00000011, B00000111, B00001111, B00011111, B00011111, B00011110, B00011100, B00011100, B00011100, B00011100, B00011100,
+  B00011000, B00010010, B00000100, B00000000, B00000011, B00011111, B00011111, B00011111, B00011111, B00011100, B00011000,
+  B00011111, B00011111, B00011111, B00011111, B00011111, B00001111, B00000000, B00000000, B00011111, B00011111, B00011111,
+  B00011111, B00011111, B00000000, B00011111, B00011111, B00011111, B00011111, B00011111, B00000000, B00000000, B00000000,
+  B00011000, B00011111, B00011111, B00011111, B00011111, B00000011, B00000000, B00000100, B00000100, B00000100, B00000100,
+  B00001100, B00000000, B00000000, B00010000, B00011111, B00011111, B00011111, B00011111, B00011111, B00001111, B00001111,
+  B00001111, B00001111, B10000111,
+  // Title row 5
+  B00011000, B00011000, B00011001, B00011001, B00011001, B00010001, B00000001, B00011111, B00011111, B00011111, B00011111,
+  B00011111, B00010000, B00000000, B00000011, B00011111, B00011111, B00011111, B00011111, B00000011, B00000011, B00000011,
+  B00000011, B00000001, B00000000, B00000000, B00000000, B00011100, B00011111, B00011111, B00011111, B00011111, B00001111,
+  B00001110, B00001111, B00011111, B00011111, B00011111, B00011111, B00011100, B00000000, B00000000, B00011111, B00011111,
+  B00011111, B00011111, B00011111, B00010000, B00011000, B00011111, B00011111, B00011111, B00011111, B00001111, B00000000,
+  B00011000, B00011111, B00011111, B00011111, B00011111, B00011111, B00010001, B00010000, B00010010, B00010110, B10010000,
+  // Title row 6
+  B00001100, B00000100, B00000100, B00000100, B00001100, B00000000, B00000100, B00001100, B00000100, B00000100, B00000100,
+  B00001000, B00000000, B00001100, B00000100, B00000100, B00000100, B00001100, B00000000, B00001000, B00000001, B00000011,
+  B00000011, B00000111, B00000111, B00000111, B00000111, B00000111, B00000111, B00000111, B00000011, B00000001, B00001100,
+  B00000000, B00000111, B00000111, B00000111, B00000111, B00000111, B00000000, B00000100, B00000100, B00000100, B00001100,
+  B00000000, B00000000, B00000111, B00000111, B00000111, B00000111, B00000111, B00000000, B00000100, B00000000, B00000111,
+  B00000111, B00000111, B00000111, B00000111, B00000000, B00000000, B00000011, B00000111, B00000111, B00000111, B00000111,
+  B00000111, B00000111, B00000111, B00000111, B00000011, B00000001, B00000100, B00000000, B00000111, B00000111, B00000111,
+  B00000111, B00000111, B00000111, B00000111, B00000111, B00000111, B00000111, B00000011, B00000000, B00000100, B00000100,
+  B00000100, B00001000, B00000000, B00000000, B00000000, B00000000, B00010000, B00001000, B00000100, B00000100, B00000100,
+  B00000100, B00000100, B00000100, B00000100, B00000100, B10001000,
+  // Title row 7
+  B00011000, B00011000, B00011000, B00011011, B00011001, B00011001, B00000001, B00000001, B00001011, B00011000, B00011000,
+  B00011001, B00011011, B00010001, B00000001, B00000001, B00011010, B00011000, B00011011, B00011001, B00011001, B00011001,
+  B00000011, B00000000, B00011000, B00011011, B00011001, B00011001, B00011001, B00010001, B00000011, B00001100, B00010000,
+  B00000000, B00011011, B00011001, B00011001, B00011001, B00011001, B00000011, B00000000, B00000000, B00011011, B00011001,
+  B00011001, B00011001, B00011001, B00011001, B00011001, B00011001, B00011011, B00000000, B00000000, B00000000, B00000000,
+  B00000000, B00011011, B00011001, B00011001, B00011001, B00011001, B00011001, B00011001, B00011001, B00011001, B00011001,
+  B00011001, B00010010, B00000100, B00000000, B00000000, B00000000, B00011011, B00011001, B00011001, B00011001, B00011001,
+  B00011001, B00011001, B00011001, B00011001, B00011001, B00011001, B00011011, B00011000, B00000000, B00000011, B00011001,
+  B00011001, B00011001, B00011001, B00011001, B00011001, B00011001, B00011001, B00011001, B00011001, B00011010, B00011000,
+  B00010000, B00000000, B00000100, B00000010, B00000010, B00010001, B00010001, B00011001, B00011001, B00011001, B00011001,
+  B00011001, B00011001, B00011001, B00011010, B00011000, B10011000,
+  // Title row 8
+  B00000001, B00000111, B00001111, B00011111, B00011111, B00011111, B00011110, B00011000, B00000001, B00000011, B00001111,
+  B00011111, B00011111, B00011111, B00011110, B00011000, B00010011, B00000111, B00011111, B00011111, B00011111, B00011111,
+  B00011100, B00000000, B00000011, B00001111, B00011111, B00011111, B00011111, B00011110, B00010000, B00000001, B00000000,
+  B00001111, B00011111, B00011111, B00011111, B00011111, B00011000, B00000000, B00000000, B00011111, B00011111, B00011111,
+  B00011111, B00011111, B00011111, B00011111, B00011111, B00011111, B00011110, B00000000, B00000000, B00000000, B00000000,
+  B00011111, B00011111, B00011111, B00011111, B00011111, B00011111, B00000001, B00011111, B00011111, B00011111, B00011111,
+  B00011111, B00011111, B00000000, B00000000, B00011100, B00011111, B00011111, B00011111, B00011111, B00011111, B00000011,
+  B00000001, B00000101, B00000101, B00001101, B00000001, B00011001, B00000000, B00011000, B00011110, B00011111, B00011111,
+  B00011111, B00011111, B00000111, B00000001, B00011001, B00011111, B00011111, B00011111, B00011111, B00001111, B00000011,
+  B00010000, B00011100, B00011110, B00011111, B00011111, B00011111, B00001111, B00000011, B00010001, B00011101, B00011111,
+  B00011111, B00011111, B00011111, B00000111, B10000001,
+  // Title row 9
+  B00000001, B00000011, B00001111, B00011111, B00011111, B00011111, B00011110, B00011000, B00000001, B00000111, B00001111,
+  B00011111, B00011111, B00011111, B00011111, B00011111, B00011111, B00011111, B00011111, B00011111, B00011111, B00011000,
+  B00000000, B00000001, B00000111, B00011111, B00011111, B00011111, B00011110, B00011000, B00000000, B00000111, B00011111,
+  B00011111, B00011111, B00011111, B00000000, B00000000, B00000001, B00011111, B00011111, B00011111, B00011111, B00000001,
+  B00001111, B00011111, B00011111, B00011111, B00011111, B00010000, B00000000, B00000000, B00011111, B00011111, B00011111,
+  B00011111, B00011111, B00000111, B00000000, B00011111, B00011111, B00011111, B00011111, B00011111, B00000011, B00000000,
+  B00011000, B00011111, B00011111, B00011111, B00011111, B00011111, B00001111, B00001111, B00001111, B00001111, B00001111,
+  B00000011, B00000000, B00010000, B00011110, B00011111, B00011111, B00011111, B00011111, B00001111, B00011100, B00011100,
+  B00011111, B00011111, B00010011, B00000011, B00001011, B00001001, B00000000, B00000110, B00001111, B00011111, B00011111,
+  B00011111, B00011111, B00011101, B00011100, B00011100, B00011100, B10011000,
+  // Title row 10
+  B00000011, B00000111, B00001111, B00011111, B00011111, B00011110, B00011000, B00000001, B00000111, B00011111, B00011111,
+  B00011111, B00011110, B00011001, B00000011, B00000111, B00001111, B00011111, B00011111, B00011100, B00010000, B00000000,
+  B00000011, B00001111, B00011111, B00011111, B00011111, B00011110, B00011111, B00011111, B00011111, B00011111, B00011110,
+  B00000000, B00000000, B00011111, B00011111, B00011111, B00011111, B00001110, B00000110, B00000111, B00011111, B00011111,
+  B00011111, B00011111, B00011000, B00000000, B00011111, B00011111, B00011111, B00011111, B00011111, B00011000, B00011000,
+  B00011111, B00011111, B00011111, B00011111, B00001111, B00000000, B00010000, B00011111, B00011111, B00011111, B00011111,
+  B00011111, B00011001, B00011000, B00011001, B00011001, B00011011, B00000000, B00010000, B00011100, B00011111, B00011111,
+  B00011111, B00011111, B00000011, B00010000, B00011100, B00011111, B00011111, B00011111, B00001111, B00000011, B00011000,
+  B00011100, B00011110, B00011110, B00011110, B00011110, B00010010, B00011000, B00011100, B00011111, B00011111, B00001111,
+  B00000111, B10000011,
+  // Title row 11
+  B00000001, B00000001, B00000001, B00000001, B00000001, B00000000, B00000000, B00000001, B00000001, B00000001, B00000001,
+  B00000001, B00000000, B00000000, B00000001, B00000001, B00000001, B00000001, B00000000, B00000000, B00000000, B00000001,
+  B00000001, B00000001, B00000001, B00000001, B00000001, B00000001, B00000001, B00000001, B00000000, B00000000, B00000001,
+  B00000001, B00000001, B00000001, B00000000, B00000000, B00000000, B00000001, B00000001, B00000001, B00000001, B00000001,
+  B00000000, B00000001, B00000001, B00000001, B00000001, B00000001, B00000001, B00000001, B00000001, B00000001, B00000001,
+  B00000000, B00000000, B00000000, B00000001, B00000001, B00000001, B00000001, B00000001, B00000001, B00000001, B00000001,
+  B00000001, B00000001, B00000000, B00000000, B00000001, B00000001, B00000001, B00000001, B00000001, B00000000, B00000000,
+  B00000001, B00000001, B00000001, B00000001, B00000001, B00000000, B00000000, B00000000, B00000001, B00000001, B00000001,
+  B00000001, B00000001, B00000001, B00000001, B10000001
+};
+
+#endif
+
+#define BM_COUNT 73
+
+/*
+ * The size of each bitmap, in the same order as the bitmaps
+ */
+const BitmapInfo bitmapInfo[BM_COUNT] PROGMEM = {
+  { BM_EXCLAIM, 3, 5 },
+  { BM_STAR, 3, 5 },
+  { BM_HYPHEN, 3, 5 },
+  { BM_DOT, 3, 5 },
+  { BM_0, 3, 5 },
+  { BM_1, 3, 5 },
+  { BM_2, 3, 5 },
+  { BM_3, 3, 5 },
+  { BM_4, 3, 5 },
+  { BM_5, 3, 5 },
+  { BM_6, 3, 5 },
+  { BM_7, 3, 5 },
+  { BM_8, 3, 5 },
+  { BM_9, 3, 5 },
+  { BM_EQUALS, 3, 5 },
+  { BM_QUESTION, 4, 5 },
+  { BM_A, 3, 5 },
+  { BM_B, 3, 5 },
+  { BM_C, 3, 5 },
+  { BM_D, 3, 5 },
+  { BM_E, 3, 5 },
+  { BM_F, 3, 5 },
+  { BM_G, 3, 5 },
+  { BM_H, 3, 5 },
+  { BM_I, 3, 5 },
+  { BM_J, 3, 5 },
+  { BM_K, 3, 5 },
+  { BM_L, 3, 5 },
+  { BM_M, 5, 5 },
+  { BM_N, 4, 5 },
+  { BM_P, 3, 5 },
+  { BM_Q, 3, 5 },
+  { BM_R, 3, 5 },
+  { BM_S, 3, 5 },
+  { BM_T, 3, 5 },
+  { BM_U, 3, 5 },
+  { BM_V, 3, 5 },
+  { BM_W, 5, 5 },
+  { BM_X, 3, 5 },
+  { BM_Y, 3, 5 },
+  { BM_Z, 3, 5 },
+  { BM_INVERTED_Y, 3, 5 },
+  { BM_BACK, 3, 5 },
+  { BM_MYSTERY, 9, 5 },
+  { BM_ALIEN30_1, 5, 5 },
+  { BM_ALIEN30_2, 5, 5 },
+  { BM_ALIEN20_1, 7, 5 },
+  { BM_ALIEN20_2, 7, 5 },
+  { BM_ALIEN10_1, 8, 5 },
+  { BM_ALIEN10_2, 8, 5 },
+  { BM_BASE, 9, 5 },
+  { BM_BASE_DEAD, 9, 5 },
+  { BM_DEFENCE, 14, 5 },
+  { BM_EXPLOSION, 7, 5 },
+  { BM_LASER, 1, 4 },
+  { BM_BOMB_1_1, 2, 5 },
+  { BM_BOMB_1_2, 2, 5 },
+  { BM_BOMB_2_1, 3, 5 },
+  { BM_BOMB_2_2, 3, 5 },
+  { BM_BOX_TOP, 9, 5 },
+  { BM_BOX_SIDE, 1, 5 },
+  { BM_BOX_BOTTOM, 9, 5 },
+  { BM_TITLE01, 72, 5 },
+  { BM_TITLE02, 76, 5 },
+  { BM_TITLE03, 71, 5 },
+  { BM_TITLE04, 69, 5 },
+  { BM_TITLE05, 66, 5 },
+  { BM_TITLE06, 105, 5 },
+  { BM_TITLE07, 116, 5 },
+  { BM_TITLE08, 115, 5 },
+  { BM_TITLE09, 106, 5 },
+  { BM_TITLE10, 101, 5 },
+  { BM_TITLE11, 93, 1 }
+};
+
+#endif
@@ -19,21 +19,19 @@
  * Create a bomb of a random type at the coordinates given
  * Yeah... I know... reuse of code. Why didn't I just call the other function?
  */
-void Bomb::create (SSD1306 &screen, uint8_t start_x, uint8_t start_y) {
+void Bomb::create (uint8_t start_x, uint8_t start_y) {
   x = start_x;
   y = start_y;
-  bombType = random (FAST_BOMB, SLOW_BOMB + 1);
-  draw (screen);
+  bombType = gameRandom.range (FAST_BOMB, SLOW_BOMB + 1);
 }
 
 /*
  * Create a bomb of a specified type at the coordinates given
  */
-void Bomb::create (SSD1306 &screen, uint8_t start_x, uint8_t start_y, uint8_t bType) {
+void Bomb::create (uint8_t start_x, uint8_t start_y, uint8_t bType) {
   x = start_x;
   y = start_y;
   bombType = bType;
-  draw (screen);
 }
 
 /*
@@ -41,17 +39,17 @@ void Bomb::create (SSD1306 &screen, uint8_t start_x, uint8_t start_y, uint8_t bT
  */
 boolean Bomb::draw (SSD1306 &screen) {
   if (bombType) {
-    screen.drawBitmap (pgm_read_byte (&bombTable[bombType][y & 1]), x, y);
+    screen.drawSprite (pgm_read_byte (&bombTable[bombType][y & 1]), x, y);
     return (true);
   }
   return (false);
 }
 
 /*
- * Move the bomb - erases the space where the bomb was, but does not re-draw
+ * Move the bomb
  * Returns true if a bomb was moved
  */
-boolean Bomb::move (SSD1306 &screen) {
+boolean Bomb::move () {
   switch (bombType) {
     case NO_BOMB:
       return (false);
@@ -62,8 +60,6 @@ boolean Bomb::move (SSD1306 &screen) {
       }
       delay = true;
   }
-  // Clear the space where the bomb was
-  screen.clearRect (x, y, 1 + bombType, 5);
   // Move the bomb down a pixel
   y ++;
   // Has it hit the bottom of the screen?
@@ -106,3 +102,38 @@ boolean Bomb::exists () {
 void Bomb::destroy () {
   bombType = 0;
 }
+
+/*
+ * Has the bomb changed since it was last drawn?
+ */
+boolean Bomb::changed () {
+  return (drawnType != bombType || drawn_x != x || drawn_y != y);
+}
+
+/*
+ * Rub out the bomb where it was last drawn
+ */
+void Bomb::erase (SSD1306 &screen) {
+  if (drawnType && changed ()) {
+    screen.clearRect (drawn_x, drawn_y, 1 + drawnType, 5);
+  }
+}
+
+/*
+ * Draw the bomb where it is now
+ */
+void Bomb::show (SSD1306 &screen) {
+  if (changed ()) {
+    draw (screen);
+    drawnType = bombType;
+    drawn_x = x;
+    drawn_y = y;
+  }
+}
+
+/*
+ * The screen has been cleared
+ */
+void Bomb::offScreen () {
+  drawnType = NO_BOMB;
+}
@@ -13,6 +13,7 @@
 
 #include "SSD1306.h"
 #include "bitmaps.h"
+#include "rng.h"
 
 #define NO_BOMB 0
 #define FAST_BOMB 1
@@ -20,21 +21,29 @@
 
 class Bomb {
   public:
-    void create (SSD1306 &screen, uint8_t start_x, uint8_t start_y);
-    void create (SSD1306 &screen, uint8_t start_x, uint8_t start_y, uint8_t bType);
-    boolean move (SSD1306 &screen);
+    void create (uint8_t start_x, uint8_t start_y);
+    void create (uint8_t start_x, uint8_t start_y, uint8_t bType);
+    boolean move ();
     uint8_t getX ();
     uint8_t getY ();
     void destroy ();
     boolean draw (SSD1306 &screen);
     boolean exists ();
     uint8_t getPower ();
+    void erase (SSD1306 &screen);   // Rub out the bomb where it was last drawn, if it's changed
+    void show (SSD1306 &screen);    // ... and draw it where it is now
+    void offScreen ();              // The screen has been cleared, so draw it from scratch next time
     
   private:
+    boolean changed ();
     uint8_t bombType; // 0 - no bomb, 1 - fast wiggly, 2 - slow big
     uint8_t x;
     uint8_t y;
     boolean delay; // delay toggle switch for slow bombs
+    // What's on the screen
+    uint8_t drawnType; // NO_BOMB if not drawn
+    uint8_t drawn_x;
+    uint8_t drawn_y;
 };
 
 #endif
@@ -0,0 +1,279 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * Serial console
+ * Commands are typed a character at a time, so they're collected over as
+ * many frames as it takes, and run when enter is pressed (one a frame).
+ * Answers are printed a line at a time, when there's room in the serial
+ * buffer, so Serial.print () never has to wait (see console.h).
+ * Only enabled when CONSOLE is defined in console.h
+ */
+#include "console.h"
+#include "scenario.h"
+#include "trace.h"
+
+#ifdef CONSOLE
+
+// What's being printed
+#define SHOW_NOTHING 0
+#define SHOW_TUNABLE 1              // One tunable (showLine)
+#define SHOW_TUNABLES 2             // All of them, a line each
+#define SHOW_FRAMES 3               // The frame times, then the histogram a bucket a line
+#define SHOW_OK 4
+#define SHOW_HELP 5                 // The command wasn't understood
+#define SHOW_LIMITS 6               // What a tunable can be set to (showLine)
+#define SHOW_TRACE 7                // The function trace, a mark a line (see Trace::dumpLine)
+
+Console console;
+
+// The tunables' names, in the order of the TUNE_ numbers
+const char tuneBaseMove[] PROGMEM = "baseMove";
+const char tuneLaserMove[] PROGMEM = "laserMove";
+const char tuneMysteryMove[] PROGMEM = "mysteryMove";
+const char tuneAlienStep[] PROGMEM = "alienStep";
+const char tuneExplosion[] PROGMEM = "explosion";
+const char tuneBombMove[] PROGMEM = "bombMove";
+const char tuneBaseDead[] PROGMEM = "baseDead";
+const char tuneInterLevel[] PROGMEM = "interLevel";
+const char tuneMysteryHit[] PROGMEM = "mysteryHit";
+const char tuneMysteryInterval[] PROGMEM = "mysteryInterval";
+const char tuneBombFactor[] PROGMEM = "bombFactor";
+
+const char * const tunableNames[TUNABLES] PROGMEM = {
+  tuneBaseMove, tuneLaserMove, tuneMysteryMove, tuneAlienStep, tuneExplosion, tuneBombMove,
+  tuneBaseDead, tuneInterLevel, tuneMysteryHit, tuneMysteryInterval, tuneBombFactor
+};
+
+/*
+ * The lowest and highest each can be set to, in the same order
+ * The game does its sums on them in ints, so these keep them from
+ * overflowing - the alien step is doubled and has up to 220 added, and the
+ * bomb factor is multiplied by up to 64 * 4.
+ */
+const int16_t tunableLimits[TUNABLES][2] PROGMEM = {
+  { 1, 1000 },      // baseMove
+  { 1, 1000 },      // laserMove
+  { 1, 1000 },      // mysteryMove
+  { 1, 10000 },     // alienStep
+  { 1, 10000 },     // explosion
+  { 1, 1000 },      // bombMove
+  { 1, 10000 },     // baseDead
+  { 1, 10000 },     // interLevel
+  { 1, 10000 },     // mysteryHit
+  { 100, 32767 },   // mysteryInterval
+  { 1, 100 }        // bombFactor
+};
+
+void Console::init (const int *d) {
+  defaults = d;
+  for (uint8_t i = 0; i < TUNABLES; i ++) {
+    tunable[i] = pgm_read_word (&defaults[i]);
+  }
+  frameBest = 0xFFFFFFFF;
+  secondStart = Clock::millis ();
+}
+
+/*
+ * Called once each time round the loop
+ * Returns what the loop needs to do (CONSOLE_NOTHING unless the scenarios
+ * were asked for)
+ */
+uint8_t Console::poll () {
+  uint8_t request = CONSOLE_NOTHING;
+  unsigned long start = Clock::micros ();
+  // Read what's been typed, until a command is complete or the time's up
+  while (Serial.available () && Clock::micros () - start < CONSOLE_SLICE) {
+    char c = Serial.read ();
+    if (c == '\r' || c == '\n') {
+      if (length) {
+        line[length] = 0;
+        length = 0;
+        request = run ();
+        break;
+      }
+    } else if (length < CONSOLE_LINE) {
+      line[length ++] = c;
+    }
+  }
+  // The telemetry, once a second (skipped if something else is being printed)
+  if (Clock::millis () - secondStart >= 1000) {
+    if (telemetry && showing == SHOW_NOTHING && Serial.availableForWrite () >= CONSOLE_ROOM) {
+      Serial.print (F("TELEMETRY "));
+      Serial.print (secondFrames);
+      Serial.print (' ');
+      Serial.print (secondFrames ? secondTotal / secondFrames : 0);
+      Serial.print (' ');
+      Serial.println (secondWorst);
+    }
+    secondFrames = 0;
+    secondTotal = secondWorst = 0;
+    secondStart = Clock::millis ();
+  }
+  // Then the next line of any answer
+  if (showing != SHOW_NOTHING && Serial.availableForWrite () >= CONSOLE_ROOM) {
+    if (!show ()) showing = SHOW_NOTHING;
+  }
+  return (request);
+}
+
+/*
+ * Run the command that's been typed
+ * Returns what the loop needs to do
+ */
+uint8_t Console::run () {
+  char *command = strtok (line, " ");
+  char *name = strtok (NULL, " ");
+  char *value = strtok (NULL, " ");
+  int8_t t = name ? findTunable (name) : -1;
+  showing = SHOW_HELP;
+  if (!command) {
+    // Just spaces
+  } else if (strcmp_P (command, PSTR ("get")) == 0) {
+    if (!name) {
+      showing = SHOW_TUNABLES;
+      showLine = 0;
+    } else if (t >= 0) {
+      showing = SHOW_TUNABLE;
+      showLine = t;
+    }
+  } else if (strcmp_P (command, PSTR ("set")) == 0) {
+    long v = value ? atol (value) : 0;
+    if (t >= 0) {
+      showLine = t;
+      if (v >= (int16_t)pgm_read_word (&tunableLimits[t][0]) && v <= (int16_t)pgm_read_word (&tunableLimits[t][1])) {
+        tunable[t] = v;
+        showing = SHOW_TUNABLE;
+      } else {
+        showing = SHOW_LIMITS;
+      }
+    }
+  } else if (strcmp_P (command, PSTR ("reset")) == 0) {
+    init (defaults);
+    showing = SHOW_OK;
+  } else if (strcmp_P (command, PSTR ("frames")) == 0) {
+    showing = SHOW_FRAMES;
+    showLine = 0;
+  } else if (strcmp_P (command, PSTR ("telemetry")) == 0) {
+    if (name) {
+      telemetry = strcmp_P (name, PSTR ("on")) == 0;
+      showing = SHOW_OK;
+    }
+  } else if (strcmp_P (command, PSTR ("bench")) == 0) {
+#ifdef SCENARIO_BENCH
+    showing = SHOW_NOTHING;
+    return (CONSOLE_BENCH);
+#endif
+  } else if (strcmp_P (command, PSTR ("trace")) == 0) {
+#ifdef TRACE_RAM
+    showing = SHOW_TRACE;
+    trace.dumpStart ();
+#endif
+  }
+  return (CONSOLE_NOTHING);
+}
+
+/*
+ * Returns the tunable's number, or -1 if there isn't one called that
+ */
+int8_t Console::findTunable (const char *name) {
+  for (uint8_t i = 0; i < TUNABLES; i ++) {
+    if (strcmp_P (name, (const char *)pgm_read_ptr (&tunableNames[i])) == 0) return (i);
+  }
+  return (-1);
+}
+
+/*
+ * Print the next line of the answer
+ * Format:
+ * alienStep 49
+ * alienStep must be 1 to 10000             (set with a value out of range)
+ * FRAMES 1200 MIN 1020 AVG 4310 MAX 9876   (microseconds, since last asked)
+ * FRAMES <1 3                              (frames under 1ms, then 2ms, 4ms...)
+ * TELEMETRY 60 4310 9876                   (frames in the last second, average and worst)
+ */
+boolean Console::show () {
+  switch (showing) {
+    case SHOW_TUNABLE:
+    case SHOW_TUNABLES:
+      Serial.print ((const __FlashStringHelper *)pgm_read_ptr (&tunableNames[showLine]));
+      Serial.print (' ');
+      Serial.println (tunable[showLine]);
+      showLine ++;
+      return (showing == SHOW_TUNABLES && showLine < TUNABLES);
+    case SHOW_FRAMES:
+      Serial.print (F("FRAMES "));
+      if (showLine == 0) {
+        Serial.print (frames);
+        Serial.print (F(" MIN "));
+        Serial.print (frames ? frameBest : 0);
+        Serial.print (F(" AVG "));
+        Serial.print (frames ? frameTotal / frames : 0);
+        Serial.print (F(" MAX "));
+        Serial.println (frameWorst);
+      } else {
+        uint8_t bucket = showLine - 1;
+        Serial.print (bucket == CONSOLE_BUCKETS - 1 ? '>' : '<');
+        Serial.print (1 << (bucket == CONSOLE_BUCKETS - 1 ? bucket - 1 : bucket));
+        Serial.print (' ');
+        Serial.println (histogram[bucket]);
+      }
+      if (++ showLine <= CONSOLE_BUCKETS) return (true);
+      // All shown, so start again
+      frames = 0;
+      frameTotal = frameWorst = 0;
+      frameBest = 0xFFFFFFFF;
+      memset (histogram, 0, sizeof (histogram));
+      return (false);
+    case SHOW_LIMITS:
+      Serial.print ((const __FlashStringHelper *)pgm_read_ptr (&tunableNames[showLine]));
+      Serial.print (F(" must be "));
+      Serial.print ((int16_t)pgm_read_word (&tunableLimits[showLine][0]));
+      Serial.print (F(" to "));
+      Serial.println ((int16_t)pgm_read_word (&tunableLimits[showLine][1]));
+      return (false);
+#ifdef TRACE_RAM
+    case SHOW_TRACE:
+      return (trace.dumpLine ());
+#endif
+    case SHOW_OK:
+      Serial.println (F("OK"));
+      return (false);
+    default:
+      Serial.println (F("? get set reset frames telemetry bench trace"));
+      return (false);
+  }
+}
+
+void Console::frameStart () {
+  frameTime = Clock::micros ();
+}
+
+/*
+ * Add the frame to the times
+ */
+void Console::frameEnd () {
+  unsigned long taken = Clock::micros () - frameTime;
+  frames ++;
+  frameTotal += taken;
+  if (taken < frameBest) frameBest = taken;
+  if (taken > frameWorst) frameWorst = taken;
+  // Find the bucket (1ms, 2ms, 4ms...)
+  uint8_t bucket = 0;
+  for (unsigned long ms = taken >> 10; ms && bucket < CONSOLE_BUCKETS - 1; ms = ms >> 1) {
+    bucket ++;
+  }
+  if (histogram[bucket] < 0xFFFF) histogram[bucket] ++;
+  secondFrames ++;
+  secondTotal += taken;
+  if (taken > secondWorst) secondWorst = taken;
+}
+
+#endif
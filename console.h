@@ -0,0 +1,106 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef console_h
+#define console_h
+#include <Arduino.h>
+#include "hal.h"
+
+/*
+ * Uncomment for a console on the serial port, for trying out the game's
+ * timings without flashing it each time. Type a command and press enter:
+ *
+ *   get                 List the tunables
+ *   get <name>          ... or just one
+ *   set <name> <value>  Change one (each has its limits, see console.cpp)
+ *   reset               Put them all back as they were built
+ *   frames              Show the frame times since the last time, and start again
+ *   telemetry on|off    Print the frames each second
+ *   bench               Run the worst case scenarios (needs SCENARIO_BENCH, see scenario.h)
+ *   trace               Print the function trace (needs TRACE_RAM, see trace.h)
+ *
+ * The console is looked at once each time round the loop, between frames,
+ * and only takes CONSOLE_SLICE microseconds reading what's been typed. It
+ * only prints a line when it fits in the serial buffer, so it never waits
+ * for the serial port - longer answers come out a line per frame (the trace
+ * too, which isn't recorded until it's all been printed). bench stops the
+ * game while it runs.
+ */
+//#define CONSOLE
+#define CONSOLE_SLICE 100           // Microseconds each frame spent reading commands
+#define CONSOLE_LINE 32             // The longest command
+#define CONSOLE_ROOM 48             // Serial buffer space needed to print a line (the longest is 46)
+#define CONSOLE_BUCKETS 8           // Frame time histogram buckets, doubling from 1ms (the last one catches everything else)
+
+// The tunables (the defaults are the #defines in Invaders.ino)
+#define TUNE_BASE_MOVE 0
+#define TUNE_LASER_MOVE 1
+#define TUNE_MYSTERY_MOVE 2
+#define TUNE_ALIEN_STEP 3
+#define TUNE_EXPLOSION 4
+#define TUNE_BOMB_MOVE 5
+#define TUNE_BASE_DEAD 6
+#define TUNE_INTER_LEVEL 7
+#define TUNE_MYSTERY_HIT 8
+#define TUNE_MYSTERY_INTERVAL 9
+#define TUNE_BOMB_FACTOR 10
+#define TUNABLES 11
+
+// What poll () wants the loop to do
+#define CONSOLE_NOTHING 0
+#define CONSOLE_BENCH 1             // Run the scenarios
+
+#ifdef CONSOLE
+
+class Console {
+  public:
+    void init (const int *defaults);    // Start, with the tunables' defaults (in progmem)
+    uint8_t poll ();                    // Read and run commands, and print the next line of any answer
+    void frameStart ();                 // A game frame is starting
+    void frameEnd ();                   // ... and has finished
+    int tunable[TUNABLES];
+
+  private:
+    uint8_t run ();                     // Run the command in the line
+    int8_t findTunable (const char *name);
+    boolean show ();                    // Print the next line of the answer - returns false when there's no more
+    const int *defaults;
+    char line[CONSOLE_LINE + 1];        // The command being typed
+    uint8_t length;
+    uint8_t showing;                    // The answer being printed
+    uint8_t showLine;                   // ... and the next line of it
+    boolean telemetry;
+    unsigned long frameTime;            // When the frame started (micros)
+    // Since the frames were last shown
+    unsigned long frames;
+    unsigned long frameTotal;           // For the average
+    unsigned long frameBest;
+    unsigned long frameWorst;
+    uint16_t histogram[CONSOLE_BUCKETS];
+    // In the last second (for the telemetry)
+    unsigned long secondStart;          // millis
+    uint16_t secondFrames;
+    unsigned long secondTotal;
+    unsigned long secondWorst;
+};
+
+extern Console console;
+
+#define CONSOLE_FRAME_START() console.frameStart ()
+#define CONSOLE_FRAME_END() console.frameEnd ()
+
+#else
+
+#define CONSOLE_FRAME_START()
+#define CONSOLE_FRAME_END()
+
+#endif
+
+#endif
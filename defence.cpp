@@ -15,10 +15,12 @@
  * separate bitmap.
  * In either scenario, the contraints of the Arduino architecture are
  * limiting factors.
- * The Arduino has insufficient ROM space for all possible damage scenarios
- * and has insufficient RAM to make a separate bitmap for each base as well
- * as the screen buffer.
- * As such, I use the screen buffer itself for collision detection.
+ * The Arduino has insufficient ROM space for all possible damage scenarios,
+ * but a defence is only 14 pixels wide, so each one keeps its own copy of
+ * its bitmap in RAM (56 bytes for the four of them). The bitmap is used for
+ * collision detection, so the game doesn't need the screen to play, and the
+ * screen just draws whatever is left of it.
+ * The aliens wipe out any part of a defence they walk over (see clearRect).
  * This does however, cause an issue when the aliens descend below the top
  * of the defences.
  * The solution to this is to tell the defences to ignore the pixels above
@@ -26,13 +28,19 @@
  */
 #include "defence.h"
 #include "bitmaps.h"
+#include "rng.h"
+#include "trace.h"
 
 /*
  * Set up the defence as the new undamaged bitmap
  */
-void Defence::init (SSD1306 &screen, uint8_t x) {
+void Defence::init (uint8_t x) {
   defence_x = x;
-  screen.drawBitmap (BM_DEFENCE, x, DEFENCE_TOP);
+  BitmapReader reader (BM_DEFENCE);
+  for (uint8_t i = 0; i < DEFENCE_WIDTH; i ++) {
+    columns[i] = reader.next () & BITMAP_COLUMN;
+  }
+  damaged = true;
 }
 
 /*
@@ -49,20 +57,22 @@ void Defence::init (SSD1306 &screen, uint8_t x) {
  * The power argument provides an upper limit to the damage created if a
  * collision is detected.
  */
-boolean Defence::collisionDetect (SSD1306 &screen, uint8_t x, uint8_t y, uint8_t alien_y, uint8_t power) {
+boolean Defence::collisionDetect (uint8_t x, uint8_t y, uint8_t alien_y, uint8_t power) {
+  TRACE_SCOPE (TRACE_DEFENCE_COLLISION);
   int boom_x, boom_y;
   if (withinBounds (x, y, alien_y)) {
     // Now we need to see if there's a pixel at the coordinate
-    if (screen.readPixel (x, y)) {
+    if (columns[x - defence_x] & (1 << (y - DEFENCE_TOP))) {
       // Collision detected, now blow up some of the defence
-      int pixels = 4 + random (power * 3);
+      int pixels = 4 + effectsRandom.below (power * 3);
       for (int i = 0; i < pixels; i ++) {
-         boom_x = x + ((random (-power, power) + random (-power, power)) / 2);
-         boom_y = y + ((random (-power, power) + random (-power, power)) / 2);
+         boom_x = x + ((effectsRandom.range (-power, power) + effectsRandom.range (-power, power)) / 2);
+         boom_y = y + ((effectsRandom.range (-power, power) + effectsRandom.range (-power, power)) / 2);
          if (withinBounds (boom_x, boom_y, alien_y)) {          
-           screen.clearPixel (boom_x, boom_y);
+           columns[boom_x - defence_x] &= ~(1 << (boom_y - DEFENCE_TOP));
          }
       }
+      damaged = true;
       return (true);
     }
   }
@@ -76,7 +86,7 @@ boolean Defence::withinBounds (uint8_t x, uint8_t y, uint8_t alien_y) {
   // Firstly, is the y coord withing range?
   if (y >= DEFENCE_TOP && y < DEFENCE_BOTTOM) {
     // And check the x coord
-    if (x >= defence_x && x <= (defence_x + DEFENCE_WIDTH)) {
+    if (x >= defence_x && x < (defence_x + DEFENCE_WIDTH)) {
       // Just check if it's below the bottom of the aliens (we don't want to detect alien pixels)
       return (y > alien_y);
     }
@@ -84,3 +94,56 @@ boolean Defence::withinBounds (uint8_t x, uint8_t y, uint8_t alien_y) {
   return (false);
 }
 
+/*
+ * Clear any of the defence inside the rectangle
+ */
+void Defence::clearRect (uint8_t x, uint8_t y, uint8_t w, uint8_t h) {
+  uint8_t x2 = x + w;
+  uint8_t y2 = y + h;
+  if (y2 <= DEFENCE_TOP || y >= DEFENCE_BOTTOM) return;
+  // The rows to clear
+  uint8_t mask = 0xFF;
+  if (y > DEFENCE_TOP) mask = mask << (y - DEFENCE_TOP);
+  if (y2 < DEFENCE_TOP + 8) mask = mask & ~(0xFF << (y2 - DEFENCE_TOP));
+  for (uint8_t i = 0; i < DEFENCE_WIDTH; i ++) {
+    uint8_t col_x = defence_x + i;
+    if (col_x >= x && col_x < x2 && (columns[i] & mask)) {
+      columns[i] &= ~mask;
+      damaged = true;
+    }
+  }
+}
+
+/*
+ * Draw the defence
+ */
+void Defence::draw (SSD1306 &screen) {
+  screen.drawColumns (columns, DEFENCE_WIDTH, defence_x, DEFENCE_TOP);
+}
+
+/*
+ * Bring the screen up to date
+ * If the defence has been damaged, the pixels that have gone need rubbing
+ * out, so it's drawn from scratch (which also rubs out anything in front of
+ * it). Returns true if it was.
+ */
+boolean Defence::show (SSD1306 &screen) {
+  if (damaged) {
+    screen.clearRect (defence_x, DEFENCE_TOP, DEFENCE_WIDTH, 5);
+    draw (screen);
+    damaged = false;
+    return (true);
+  }
+#ifndef SSD1306_STRIP
+  // Put back anything rubbed out by things passing over it (only the bytes that change get sent)
+  draw (screen);
+#endif
+  return (false);
+}
+
+/*
+ * The screen has been cleared
+ */
+void Defence::offScreen () {
+  damaged = true;
+}
@@ -19,11 +19,17 @@
 
 class Defence {
   public:
-    void init (SSD1306&, uint8_t); // Set the x coord and draw the defence
-    boolean collisionDetect (SSD1306&, uint8_t, uint8_t, uint8_t, uint8_t); // x and y coords, impact strength, bottom of alien grid
+    void init (uint8_t);            // Set the x coord and an undamaged bitmap
+    boolean collisionDetect (uint8_t, uint8_t, uint8_t, uint8_t); // x and y coords, bottom of alien grid, impact strength
+    void clearRect (uint8_t x, uint8_t y, uint8_t w, uint8_t h); // Rub out part of the defence
+    void draw (SSD1306&);           // Draw the defence
+    boolean show (SSD1306&);        // Bring the screen up to date - returns true if it was drawn from scratch
+    void offScreen ();              // The screen has been cleared, so draw it from scratch next time
 
   private:
     boolean withinBounds (uint8_t, uint8_t, uint8_t);
     uint8_t defence_x;
+    uint8_t columns[DEFENCE_WIDTH]; // The defence bitmap, as it's been damaged
+    boolean damaged;                // Pixels have gone since it was last drawn
 };
 #endif
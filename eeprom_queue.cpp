@@ -0,0 +1,103 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * EEPROM writing in the background
+ * Writing a byte to the EEPROM takes about 3.3ms, and EEPROM.update () sits
+ * and waits for each one. Saving a high score changes several bytes, which
+ * is long enough to see the screen stall.
+ * Instead, the bytes are queued here and written by the EEPROM ready
+ * interrupt, which goes off whenever the EEPROM can take another byte. When
+ * the queue is empty the interrupt is switched off again.
+ * Bytes are written in the order they're queued, which is what lets the
+ * high score table survive the power going off part way through (see
+ * highScoreInit ()).
+ * While anything is queued, all EEPROM access must go through here, so that
+ * reads see the bytes that haven't been written yet, and don't get in the
+ * way of a write that's in progress.
+ */
+#include "eeprom_queue.h"
+
+EepromQueue eeprom;
+
+/*
+ * Read a byte. If it's waiting to be written, the newest queued value is
+ * the one that counts.
+ */
+uint8_t EepromQueue::read (uint16_t address) {
+  noInterrupts ();
+  for (uint8_t i = head; i != tail; ) {
+    i = (i - 1) & (EE_QUEUE_SIZE - 1);
+    if (queue[i].address == address) {
+      uint8_t value = queue[i].value;
+      interrupts ();
+      return (value);
+    }
+  }
+  // Hold off the interrupt while reading (the read waits for any write that has already started)
+  Storage::readyInterrupt (false);
+  interrupts ();
+  uint8_t value = Storage::read (address);
+  if (head != tail) Storage::readyInterrupt (true);
+  return (value);
+}
+
+/*
+ * Queue a byte to be written, if it's different to what's there already
+ * If the queue is full, this waits for room.
+ */
+void EepromQueue::update (uint16_t address, uint8_t value) {
+  if (read (address) == value) return;
+  uint8_t next = (head + 1) & (EE_QUEUE_SIZE - 1);
+  while (next == tail) {
+    // Full - wait for the interrupt to make room
+  }
+  noInterrupts ();
+  queue[head].address = address;
+  queue[head].value = value;
+  head = next;
+  Storage::readyInterrupt (true);
+  interrupts ();
+}
+
+/*
+ * Wait until everything has been written
+ */
+void EepromQueue::flush () {
+  while (head != tail) {
+  }
+}
+
+/*
+ * The number of bytes still to be written
+ */
+uint8_t EepromQueue::pending () {
+  return ((head - tail) & (EE_QUEUE_SIZE - 1));
+}
+
+/*
+ * Start writing the next byte, or switch the interrupt off if there's nothing
+ * to write. Called with interrupts off, when the EEPROM is ready.
+ */
+void EepromQueue::interrupt () {
+  if (head == tail) {
+    Storage::readyInterrupt (false);
+    return;
+  }
+  Storage::write (queue[tail].address, queue[tail].value);
+  tail = (tail + 1) & (EE_QUEUE_SIZE - 1);
+}
+
+/*
+ * The EEPROM ready interrupt
+ */
+HAL_ISR (HAL_STORAGE_VECT) {
+  eeprom.interrupt ();
+}
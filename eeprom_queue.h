@@ -0,0 +1,42 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef eeprom_queue_h
+#define eeprom_queue_h
+#include <Arduino.h>
+#include "hal.h"
+
+#define EE_QUEUE_SIZE 32    // The number of bytes that can be waiting to be written (must be a power of 2, and hold a high score table save)
+
+/*
+ * A byte waiting to be written
+ */
+struct EepromWrite {
+  uint16_t address;
+  uint8_t value;
+};
+
+class EepromQueue {
+  public:
+    uint8_t read (uint16_t address);                // Read a byte (including any waiting to be written)
+    void update (uint16_t address, uint8_t value);  // Queue a byte to be written, if it has changed
+    void flush ();                                  // Wait until everything has been written
+    uint8_t pending ();                             // The number of bytes waiting to be written
+    void interrupt ();                              // Write the next byte (called by the EEPROM ready interrupt)
+
+  private:
+    volatile uint8_t head;                          // Where the next write will be added to the queue
+    volatile uint8_t tail;                          // The next write to be made
+    EepromWrite queue[EE_QUEUE_SIZE];
+};
+
+extern EepromQueue eeprom;
+
+#endif
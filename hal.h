@@ -0,0 +1,61 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef hal_h
+#define hal_h
+#include <Arduino.h>
+#include "hardware.h"
+
+/*
+ * Hardware abstraction
+ * Everything the game does to the hardware goes through these backends, each
+ * a class of static inline functions:
+ *
+ *   Clock    millis (), micros (), delay (ms), cpuMicros () - the time
+ *            actually spent running (the same as micros () on the AVR)
+ *   Buttons  init (), read () - the button port bits (set when pressed),
+ *            enableInterrupt ()
+ *   I2c      begin (clock), start (address), write (byte), stop ()
+ *   Spi      begin (clock), start (data) - select the display, for data or
+ *            commands, write (byte), stop ()
+ *   Storage  read (address), write (address, value) - start writing a byte
+ *            (only when ready), readyInterrupt (on)
+ *   Audio    init (sampleRate), output (level), sampleInterrupt (on)
+ *
+ * The interrupt handlers are written as HAL_ISR (HAL_BUTTONS_VECT) and so on,
+ * so they turn into real interrupt vectors on the AVR and plain functions
+ * the host can call.
+ * The backend is picked when compiling, with typedefs rather than virtual
+ * functions, so the AVR backend compiles to exactly the same instructions as
+ * calling Wire, SPI, EEPROM and the registers directly.
+ * The host backend (hal_host.h) is used when HAL_HOST is defined (pass
+ * -DHAL_HOST to the compiler, or use tools/host.py). It runs in its own
+ * virtual time, so a game plays the same way every time, and as fast as the
+ * PC can go.
+ */
+#ifdef HAL_HOST
+#include "hal_host.h"
+typedef HostClock Clock;
+typedef HostButtons Buttons;
+typedef HostI2c I2c;
+typedef HostSpi Spi;
+typedef HostStorage Storage;
+typedef HostAudio Audio;
+#else
+#include "hal_avr.h"
+typedef AvrClock Clock;
+typedef AvrButtons Buttons;
+typedef AvrI2c I2c;
+typedef AvrSpi Spi;
+typedef AvrStorage Storage;
+typedef AvrAudio Audio;
+#endif
+
+#endif
@@ -0,0 +1,131 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef hal_avr_h
+#define hal_avr_h
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <EEPROM.h>
+#include "hardware.h"
+
+/*
+ * The AVR backend (an Uno)
+ * These just hand on to the Arduino libraries and the registers, and are all
+ * inline, so they cost nothing.
+ */
+
+#define HAL_STORAGE_SIZE (E2END + 1)  // Bytes of EEPROM
+
+// Interrupt vectors
+#define HAL_BUTTONS_VECT BUTTON_PCINT_vect  // A button pin changed
+#define HAL_AUDIO_VECT TIMER1_COMPA_vect    // Time for the next sample
+#define HAL_STORAGE_VECT EE_READY_vect      // The EEPROM can take another byte
+#define HAL_ISR(vect) ISR (vect)
+
+struct AvrClock {
+  static inline unsigned long millis () { return ::millis (); }
+  static inline unsigned long micros () { return ::micros (); }
+  static inline void delay (unsigned long ms) { ::delay (ms); }
+  static inline unsigned long cpuMicros () { return ::micros (); }
+};
+
+/*
+ * The buttons are read straight from the port (see hardware.h)
+ */
+struct AvrButtons {
+  static inline void init () {
+    pinMode (LEFT_PIN, INPUT_PULLUP);
+    pinMode (RIGHT_PIN, INPUT_PULLUP);
+    pinMode (FIRE_PIN, INPUT_PULLUP);
+  }
+  // The buttons pull the pins low when pressed
+  static inline uint8_t read () { return ~BUTTON_PORT; }
+  static inline void enableInterrupt () {
+    BUTTON_PCMSK |= LEFT_BIT | RIGHT_BIT | FIRE_BIT;
+    PCICR |= _BV(BUTTON_PCIE);
+  }
+};
+
+struct AvrI2c {
+  static inline void begin (uint32_t clock) {
+    Wire.begin ();
+    Wire.setClock (clock);
+  }
+  static inline void start (uint8_t address) { Wire.beginTransmission (address); }
+  static inline void write (uint8_t b) { Wire.write (b); }
+  static inline void stop () { Wire.endTransmission (); }
+};
+
+/*
+ * The SPI bus is only used by the display, so it's set up once and kept
+ */
+struct AvrSpi {
+  static inline void begin (uint32_t clock) {
+    pinMode (OLED_CS_PIN, OUTPUT);
+    digitalWrite (OLED_CS_PIN, HIGH);
+    pinMode (OLED_DC_PIN, OUTPUT);
+    SPI.begin ();
+    SPI.beginTransaction (SPISettings (clock, MSBFIRST, SPI_MODE0));
+  }
+  static inline void start (boolean data) {
+    digitalWrite (OLED_DC_PIN, data);
+    digitalWrite (OLED_CS_PIN, LOW);
+  }
+  static inline void write (uint8_t b) { SPI.transfer (b); }
+  static inline void stop () { digitalWrite (OLED_CS_PIN, HIGH); }
+};
+
+struct AvrStorage {
+  static inline uint8_t read (uint16_t address) { return (EEPROM.read (address)); }
+  // Start writing a byte (the EEPROM must be ready)
+  static inline void write (uint16_t address, uint8_t value) {
+    EEAR = address;
+    EEDR = value;
+    // The write has to be started within 4 cycles of enabling it
+    EECR |= _BV(EEMPE);
+    EECR |= _BV(EEPE);
+  }
+  static inline void readyInterrupt (boolean on) {
+    if (on) {
+      EECR |= _BV(EERIE);
+    } else {
+      EECR &= ~_BV(EERIE);
+    }
+  }
+};
+
+/*
+ * Timer 2 drives the sound pin with PWM, and timer 1 interrupts at the
+ * sample rate to set the level
+ */
+struct AvrAudio {
+  static inline void init (uint16_t sampleRate) {
+    pinMode (SOUND_PIN, OUTPUT);
+    // Timer 2 - fast PWM on OC2B (the sound pin), no prescaler
+    TCCR2A = _BV(COM2B1) | _BV(WGM21) | _BV(WGM20);
+    TCCR2B = _BV(CS20);
+    OCR2B = 0;
+    // Timer 1 - clear on compare match at the sample rate, no prescaler
+    TCCR1A = 0;
+    TCCR1B = _BV(WGM12) | _BV(CS10);
+    OCR1A = (F_CPU / sampleRate) - 1;
+  }
+  static inline void output (uint8_t level) { OCR2B = level; }
+  static inline void sampleInterrupt (boolean on) {
+    if (on) {
+      TIMSK1 |= _BV(OCIE1A);
+    } else {
+      TIMSK1 &= ~_BV(OCIE1A);
+    }
+  }
+};
+
+#endif
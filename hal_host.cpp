@@ -0,0 +1,88 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * The host backend (see hal_host.h)
+ * Only built for the host - the Arduino IDE compiles every file in the
+ * sketch, so there's nothing here for the AVR.
+ */
+#ifdef HAL_HOST
+#include <chrono>
+#include "hal.h"
+#include "host_panel.h"
+
+unsigned long HostClock::now;
+uint8_t HostButtons::pins;
+boolean HostButtons::interruptOn;
+void (*HostI2c::receiver) (uint8_t address, const uint8_t *data, uint8_t length);
+unsigned long HostI2c::bytesSent;
+uint32_t HostI2c::speed = 100000;
+uint8_t HostI2c::address;
+uint8_t HostI2c::length;
+uint8_t HostI2c::data[HAL_I2C_BUFFER];
+void (*HostSpi::receiver) (boolean data, uint8_t b);
+unsigned long HostSpi::bytesSent;
+uint32_t HostSpi::speed = 4000000;
+boolean HostSpi::data;
+uint8_t HostStorage::memory[HAL_STORAGE_SIZE];
+boolean HostStorage::interruptOn;
+unsigned long HostAudio::period = 100;
+uint8_t HostAudio::level;
+boolean HostAudio::interruptOn;
+
+/*
+ * Move time on, a microsecond at a time, calling the sample interrupt when
+ * one is due. The EEPROM interrupt is called once a millisecond, which is a
+ * bit quicker than the real thing.
+ */
+void HostClock::advance (unsigned long us) {
+  while (us --) {
+    now ++;
+    if (HostAudio::interruptOn && now % HostAudio::period == 0) HAL_AUDIO_VECT ();
+    if (HostStorage::interruptOn && now % 1000 == 0) HAL_STORAGE_VECT ();
+  }
+}
+
+unsigned long HostClock::cpuMicros () {
+  return (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now ().time_since_epoch ()).count ());
+}
+
+/*
+ * Press or release buttons, as the pin change interrupt would see it
+ */
+void HostButtons::set (uint8_t bits) {
+  if (bits == pins) return;
+  pins = bits;
+  if (interruptOn) HAL_BUTTONS_VECT ();
+}
+
+/*
+ * Hand the transmission to the stand-in display (see host_panel.cpp) and
+ * anything else listening, and take as long as the real thing would
+ * (9 clocks a byte, including the address)
+ */
+void HostI2c::stop () {
+  hostPanel.i2c (address, data, length);
+  if (receiver) receiver (address, data, length);
+  bytesSent += length + 1;
+  HostClock::advance (((length + 1) * 9 * 1000000UL) / speed);
+}
+
+/*
+ * Hand the byte over (as above), and take as long as the real thing would (8 clocks)
+ */
+void HostSpi::write (uint8_t b) {
+  hostPanel.spi (data, b);
+  if (receiver) receiver (data, b);
+  bytesSent ++;
+  HostClock::advance ((8 * 1000000UL) / speed);
+}
+
+#endif
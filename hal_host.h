@@ -0,0 +1,112 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef hal_host_h
+#define hal_host_h
+#include <Arduino.h>
+#include "hardware.h"
+
+/*
+ * The host backend, for running the game on a PC (see hal.h)
+ * Nothing happens in real time. The clock only moves on when the game waits
+ * (delay) or talks to the display (at the speed the I2C clock would take),
+ * and the interrupts are called as the clock passes the time they would have
+ * gone off. The program driving it presses the buttons, and can watch what's
+ * sent to the display. Whatever is sent also goes to a stand-in display
+ * (see host_panel.h).
+ * The host build still needs an Arduino.h (and avr/pgmspace.h) for the bits
+ * of the language the game uses - boolean, PROGMEM, F (), Serial and so on.
+ * Those are in host/, along with the program that plays the game, and
+ * tools/host.py builds the lot.
+ */
+
+#define HAL_STORAGE_SIZE 1024         // The same as an Uno
+#define HAL_I2C_BUFFER 32             // The same as the Wire library
+
+// Interrupt vectors (the handlers are plain functions)
+#define HAL_BUTTONS_VECT halButtonsInterrupt
+#define HAL_AUDIO_VECT halAudioInterrupt
+#define HAL_STORAGE_VECT halStorageInterrupt
+#define HAL_ISR(vect) void vect ()
+HAL_ISR (HAL_BUTTONS_VECT);
+HAL_ISR (HAL_AUDIO_VECT);
+HAL_ISR (HAL_STORAGE_VECT);
+
+struct HostClock {
+  static inline unsigned long millis () { return (now / 1000); }
+  static inline unsigned long micros () { return (now); }
+  static inline void delay (unsigned long ms) { advance (ms * 1000); }
+  static void advance (unsigned long us);   // Move time on, calling any interrupts that fall due
+  static unsigned long cpuMicros ();        // The PC's own clock, for timing the code rather than the game
+  static unsigned long now;                 // Microseconds since starting
+};
+
+struct HostButtons {
+  static inline void init () {}
+  static inline uint8_t read () { return (pins); }
+  static inline void enableInterrupt () { interruptOn = true; }
+  static void set (uint8_t bits);           // Change the buttons held (port bits, see hardware.h)
+  static uint8_t pins;
+  static boolean interruptOn;
+};
+
+struct HostI2c {
+  static inline void begin (uint32_t clock) { speed = clock; }
+  static inline void start (uint8_t a) {
+    address = a;
+    length = 0;
+  }
+  // Anything past the end of the buffer is lost, as with the Wire library
+  static inline void write (uint8_t b) {
+    if (length < HAL_I2C_BUFFER) data[length ++] = b;
+  }
+  static void stop ();                      // Send it, and take the time it would have taken
+  // Called with each transmission, if set
+  static void (*receiver) (uint8_t address, const uint8_t *data, uint8_t length);
+  static unsigned long bytesSent;           // Including the address bytes
+  static uint32_t speed;
+  static uint8_t address;
+  static uint8_t length;
+  static uint8_t data[HAL_I2C_BUFFER];
+};
+
+struct HostSpi {
+  static inline void begin (uint32_t clock) { speed = clock; }
+  static inline void start (boolean d) { data = d; }
+  static void write (uint8_t b);            // Send it, and take the time it would have taken
+  static inline void stop () {}
+  // Called with each byte, if set
+  static void (*receiver) (boolean data, uint8_t b);
+  static unsigned long bytesSent;
+  static uint32_t speed;
+  static boolean data;                      // Sending data (rather than commands)
+};
+
+/*
+ * Writes happen straight away, so the storage is always ready
+ */
+struct HostStorage {
+  static inline uint8_t read (uint16_t address) { return (memory[address]); }
+  static inline void write (uint16_t address, uint8_t value) { memory[address] = value; }
+  static inline void readyInterrupt (boolean on) { interruptOn = on; }
+  static uint8_t memory[HAL_STORAGE_SIZE];
+  static boolean interruptOn;
+};
+
+struct HostAudio {
+  static inline void init (uint16_t sampleRate) { period = 1000000UL / sampleRate; }
+  static inline void output (uint8_t l) { level = l; }
+  static inline void sampleInterrupt (boolean on) { interruptOn = on; }
+  static unsigned long period;              // Microseconds between samples
+  static uint8_t level;                     // The last sample
+  static boolean interruptOn;
+};
+
+#endif
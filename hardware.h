@@ -18,13 +18,46 @@
 #define RIGHT_PIN 4
 #define FIRE_PIN 7
 
+/*
+ * Push button port
+ * The buttons are read straight from the port register by the pin change
+ * interrupt, so all three must be on the same port. The bits below must
+ * match the pins above (on an Uno, pins 0 - 7 are port D bits 0 - 7).
+ */
+#define BUTTON_PORT PIND              // Input register for the button port
+#define BUTTON_PCMSK PCMSK2           // Pin change mask register for the port
+#define BUTTON_PCIE PCIE2             // Pin change interrupt enable bit for the port
+#define BUTTON_PCINT_vect PCINT2_vect // Pin change interrupt vector for the port
+#define LEFT_BIT _BV(2)
+#define RIGHT_BIT _BV(4)
+#define FIRE_BIT _BV(7)
+
 /*
  * OLED display
+ * Pick the size of the panel, its controller and how it's connected. Only
+ * the driver for this display is built (see SSD1306.h). The game needs the
+ * full 64 rows.
+ * The controller and connection can also be given to the compiler (which is
+ * how tools/host.py tries them all).
  */
+#define OLED_WIDTH 128
+#define OLED_HEIGHT 64
+#ifndef OLED_CONTROLLER
+#define OLED_CONTROLLER SSD1306Controller // SSD1306Controller, SSD1309Controller or SH1106Controller
+#endif
+#ifndef OLED_TRANSPORT
+#define OLED_TRANSPORT OledI2c            // OledI2c or OledSpi
+#endif
+
+// I2C
 #define OLED_ADDR 0x3C
 #define OLED_SDA_PIN A4
 #define OLED_SCL_PIN A5
 
+// Hardware SPI (MOSI is pin 11 and SCK is pin 13)
+#define OLED_CS_PIN 10
+#define OLED_DC_PIN 9
+
 /*
  * Piezo buzzer pin
  */
@@ -0,0 +1,179 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * The high score table
+ * The table is small enough to keep in RAM, so it's loaded once at power up
+ * and all reads come from there.
+ * Rather than rewriting the same few bytes of EEPROM every time someone gets
+ * a high score, a new copy of the whole table is written each time, to the
+ * next of HS_SLOTS slots, round and round. Each cell is written 1/HS_SLOTS
+ * as often. Every copy has a sequence number (the newest wins) and a CRC,
+ * so a copy that was only partly written when the power went off is
+ * ignored, and the one before it is used instead. The table can't be torn.
+ * Slot layout: sequence (2 bytes), 5 x (score (2 bytes) + name (3 bytes)),
+ * CRC (2 bytes), spare.
+ * If there's no journal yet, the scores from the old fixed table at
+ * HS_OFFSET are brought in, so nobody loses their place.
+ * Writes go through the EEPROM queue, so they happen in the background.
+ */
+#include <util/crc16.h>
+#include "high_scores.h"
+
+HighScoreTable highScores;
+
+static_assert (2 + HS_TABLE_SIZE + 2 <= HS_SLOT_SIZE, "The high score table doesn't fit in a slot");
+static_assert (HS_JOURNAL_START >= HS_WRITING + 1, "The journal overlaps the old high score table");
+static_assert (HS_JOURNAL_START + (HS_SLOTS * HS_SLOT_SIZE) <= HAL_STORAGE_SIZE, "The journal doesn't fit in EEPROM");
+
+/*
+ * Find the newest good copy of the table and load it
+ */
+void HighScoreTable::init (boolean reset) {
+  boolean found = false;
+  memset (table, 0, sizeof (table));
+  slot = HS_SLOTS - 1;
+  sequence = 0;
+  for (uint8_t s = 0; s < HS_SLOTS; s ++) {
+    uint16_t address = slotAddress (s);
+    uint16_t crc = (eeprom.read (address + 2 + HS_TABLE_SIZE) << 8) | eeprom.read (address + 3 + HS_TABLE_SIZE);
+    if (slotCrc (s) == crc) {
+      uint16_t seq = (eeprom.read (address) << 8) | eeprom.read (address + 1);
+      // Newer (allowing for the sequence number wrapping round)?
+      if (!found || (int16_t)(seq - sequence) > 0) {
+        found = true;
+        sequence = seq;
+        slot = s;
+      }
+    }
+  }
+  if (reset) {
+    // Start again with an empty table
+    save ();
+  } else if (found) {
+    uint16_t address = slotAddress (slot) + 2;
+    for (uint8_t i = 0; i < HS_MAX; i ++) {
+      table[i].score = (eeprom.read (address) << 8) | eeprom.read (address + 1);
+      for (uint8_t j = 0; j < HS_NAME_LENGTH; j ++) {
+        table[i].name[j] = eeprom.read (address + 2 + j);
+      }
+      address += HS_RECORD_SIZE;
+    }
+  } else {
+    importOldTable ();
+  }
+}
+
+/*
+ * Read the old fixed table, if there is one, and save it as the first copy
+ * in the journal
+ */
+void HighScoreTable::importOldTable () {
+  if (eeprom.read (HS_OFFSET) != 'S' || eeprom.read (HS_OFFSET + 1) != 'I') return;
+  // Leave out an entry that was only partly written
+  uint8_t torn = eeprom.read (HS_WRITING);
+  uint16_t address = HS_START;
+  for (uint8_t i = 0; i < HS_MAX; i ++) {
+    if (i + 1 != torn) {
+      table[i].score = (eeprom.read (address) << 8) | eeprom.read (address + 1);
+      for (uint8_t j = 0; j < HS_NAME_LENGTH; j ++) {
+        table[i].name[j] = eeprom.read (address + 2 + j);
+      }
+    }
+    address += HS_RECORD_SIZE;
+  }
+  save ();
+}
+
+/*
+ * Get an entry from the table
+ */
+uint16_t HighScoreTable::getScore (uint8_t entry) {
+  return (table[entry].score);
+}
+
+const uint8_t *HighScoreTable::getName (uint8_t entry) {
+  return (table[entry].name);
+}
+
+/*
+ * Check if the score beats the lowest in the table
+ */
+boolean HighScoreTable::isNewHighScore (uint16_t score) {
+  return (score > table[findLowest ()].score);
+}
+
+/*
+ * Add a new score to the high score table, in place of the lowest
+ */
+void HighScoreTable::add (uint16_t score, const uint8_t *name) {
+  HighScore &entry = table[findLowest ()];
+  entry.score = score;
+  memcpy (entry.name, name, HS_NAME_LENGTH);
+  save ();
+}
+
+/*
+ * Find the (first) lowest score in the table
+ */
+uint8_t HighScoreTable::findLowest () {
+  uint8_t lowest = 0;
+  for (uint8_t i = 1; i < HS_MAX; i ++) {
+    if (table[i].score < table[lowest].score) {
+      lowest = i;
+    }
+  }
+  return (lowest);
+}
+
+/*
+ * Write the table to the next slot, with the next sequence number
+ * The sequence number goes first and the CRC last, but the order doesn't
+ * really matter - until the CRC matches, the old copy is the newest.
+ */
+void HighScoreTable::save () {
+  slot = (slot + 1) % HS_SLOTS;
+  sequence ++;
+  uint16_t address = slotAddress (slot);
+  uint16_t crc = 0xFFFF;
+  uint8_t b;
+  for (uint8_t i = 0; i < 2 + HS_TABLE_SIZE; i ++) {
+    if (i < 2) {
+      b = i ? sequence : sequence >> 8;
+    } else {
+      HighScore &entry = table[(i - 2) / HS_RECORD_SIZE];
+      uint8_t j = (i - 2) % HS_RECORD_SIZE;
+      b = j == 0 ? entry.score >> 8 : j == 1 ? entry.score : entry.name[j - 2];
+    }
+    crc = _crc16_update (crc, b);
+    eeprom.update (address ++, b);
+  }
+  eeprom.update (address ++, crc >> 8);
+  eeprom.update (address, crc);
+}
+
+/*
+ * Where a slot starts in EEPROM
+ */
+uint16_t HighScoreTable::slotAddress (uint8_t s) {
+  return (HS_JOURNAL_START + (s * HS_SLOT_SIZE));
+}
+
+/*
+ * The CRC of the sequence number and table in a slot
+ */
+uint16_t HighScoreTable::slotCrc (uint8_t s) {
+  uint16_t address = slotAddress (s);
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < 2 + HS_TABLE_SIZE; i ++) {
+    crc = _crc16_update (crc, eeprom.read (address + i));
+  }
+  return (crc);
+}
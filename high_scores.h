@@ -0,0 +1,61 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef high_scores_h
+#define high_scores_h
+#include <Arduino.h>
+#include "eeprom_queue.h"
+
+#define HS_MAX 5                // Maximum number of entries
+#define HS_NAME_LENGTH 3        // Three initials
+#define HS_RECORD_SIZE 5        // Entries are stored as int (2 bytes) + three initials
+
+// The journal
+#define HS_JOURNAL_START 32     // Where the journal starts in EEPROM (after the old fixed table)
+#define HS_SLOT_SIZE 32         // Sequence number (2 bytes) + table + CRC (2 bytes), rounded up
+#define HS_SLOTS 16             // The number of copies of the table kept in the journal
+#define HS_TABLE_SIZE (HS_MAX * HS_RECORD_SIZE)
+
+// The old fixed high score table (only read, to bring old scores into the journal)
+#define HS_OFFSET 0             // Where the old table was stored
+#define HS_START (HS_OFFSET + 2) // Room for the magic number
+#define HS_END (HS_START + HS_TABLE_SIZE)
+#define HS_WRITING HS_END       // Set to the entry number + 1 while an entry was being written
+
+/*
+ * A high score table entry
+ */
+struct HighScore {
+  uint16_t score;
+  uint8_t name[HS_NAME_LENGTH];
+};
+
+class HighScoreTable {
+  public:
+    void init (boolean reset);                      // Load the table (or clear it, if reset is set)
+    uint16_t getScore (uint8_t entry);              // The score of an entry (0 if unused)
+    const uint8_t *getName (uint8_t entry);         // ... and the name
+    boolean isNewHighScore (uint16_t score);        // Check if a score would make it into the table
+    void add (uint16_t score, const uint8_t *name); // Add a score, replacing the lowest
+
+  private:
+    uint8_t findLowest ();                          // The (first) entry with the lowest score
+    uint16_t slotAddress (uint8_t s);
+    uint16_t slotCrc (uint8_t s);                   // Work out the CRC of a slot, as stored in EEPROM
+    void importOldTable ();                         // Bring in the scores from the old fixed table
+    void save ();                                   // Write the table to the next slot in the journal
+    HighScore table[HS_MAX];
+    uint16_t sequence;                              // The sequence number of the newest slot
+    uint8_t slot;                                   // ... and which slot it is
+};
+
+extern HighScoreTable highScores;
+
+#endif
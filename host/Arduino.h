@@ -0,0 +1,99 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef Arduino_h
+#define Arduino_h
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+#include "binary.h"
+
+/*
+ * Just enough of the Arduino core to build the game on a PC, with the host
+ * backend (see hal.h and tools/host.py). The hardware itself is all behind
+ * the HAL, so this is only the language bits - boolean, F (), min (), the
+ * odd pin call the display driver makes, and Serial (which goes to stdout,
+ * and is typed into by the program driving the game, see host/main.cpp).
+ */
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define A4 18
+#define A5 19
+#define DEC 10
+#define HEX 16
+#define _BV(b) (1 << (b))
+
+// Macros, as on the Arduino, so the two sides can be different types
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+
+// The pins do nothing on the host
+inline void pinMode (uint8_t, uint8_t) {}
+inline void digitalWrite (uint8_t, uint8_t) {}
+
+// Nothing interrupts the host - the interrupts are called as time passes (see hal_host.cpp)
+inline void noInterrupts () {}
+inline void interrupts () {}
+
+char *itoa (int value, char *s, int radix);
+
+// Strings in progmem are just strings
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper *)(s))
+
+class Print {
+  public:
+    virtual size_t write (uint8_t c) = 0;
+    size_t print (const char *s);
+    size_t print (const __FlashStringHelper *s) { return (print ((const char *)s)); }
+    size_t print (char c) { return (write (c)); }
+    size_t print (int n, int base = DEC) { return (print ((long)n, base)); }
+    size_t print (unsigned int n, int base = DEC) { return (print ((unsigned long)n, base)); }
+    size_t print (long n, int base = DEC);
+    size_t print (unsigned long n, int base = DEC);
+    size_t println () { return (print ('\n')); }
+    template <class T> size_t println (T value) { return (print (value) + println ()); }
+    template <class T> size_t println (T value, int base) { return (print (value, base) + println ()); }
+};
+
+/*
+ * The serial port
+ * Sends to stdout, as fast as it likes, so there's always room to write.
+ * Anything typed (receive) waits in a buffer the size of the Arduino's.
+ */
+#define SERIAL_RX_BUFFER_SIZE 64
+#define SERIAL_TX_BUFFER_SIZE 64
+
+class HardwareSerial : public Print {
+  public:
+    void begin (unsigned long) {}
+    int available ();
+    int read ();
+    int availableForWrite () { return (SERIAL_TX_BUFFER_SIZE - 1); }
+    size_t write (uint8_t c);
+    boolean receive (char c);           // Type a character (host only) - returns false if the buffer is full
+
+  private:
+    char rx[SERIAL_RX_BUFFER_SIZE];
+    uint8_t head;
+    uint8_t tail;
+};
+
+extern HardwareSerial Serial;
+
+#endif
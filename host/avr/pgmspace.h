@@ -0,0 +1,31 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef pgmspace_h
+#define pgmspace_h
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Progmem on the host (see host/Arduino.h)
+ * There's only the one kind of memory, so it's all ordinary reads.
+ */
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_ptr(p) (*(void * const *)(p))
+#define memcpy_P memcpy
+#define strcmp_P strcmp
+#define strlen_P strlen
+
+#endif
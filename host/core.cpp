@@ -0,0 +1,69 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * The bits of the Arduino core the game uses, for the host (see host/Arduino.h)
+ */
+#include <stdio.h>
+#include <Arduino.h>
+
+HardwareSerial Serial;
+
+char *itoa (int value, char *s, int radix) {
+  snprintf (s, 12, radix == HEX ? "%x" : "%d", value);
+  return (s);
+}
+
+size_t Print::print (const char *s) {
+  size_t n = 0;
+  while (*s) n += write (*s ++);
+  return (n);
+}
+
+size_t Print::print (long n, int base) {
+  if (base == DEC && n < 0) return (print ('-') + print ((unsigned long)-n, base));
+  return (print ((unsigned long)n, base));
+}
+
+size_t Print::print (unsigned long n, int base) {
+  char digits[sizeof (n) * 8 + 1];
+  char *s = &digits[sizeof (digits) - 1];
+  *s = 0;
+  do {
+    uint8_t d = n % base;
+    *-- s = d < 10 ? '0' + d : 'A' + d - 10;
+    n /= base;
+  } while (n);
+  return (print (s));
+}
+
+size_t HardwareSerial::write (uint8_t c) {
+  putchar (c);
+  return (1);
+}
+
+int HardwareSerial::available () {
+  return ((head - tail) & (SERIAL_RX_BUFFER_SIZE - 1));
+}
+
+int HardwareSerial::read () {
+  if (head == tail) return (-1);
+  char c = rx[tail];
+  tail = (tail + 1) & (SERIAL_RX_BUFFER_SIZE - 1);
+  return (c);
+}
+
+boolean HardwareSerial::receive (char c) {
+  uint8_t next = (head + 1) & (SERIAL_RX_BUFFER_SIZE - 1);
+  if (next == tail) return (false);
+  rx[head] = c;
+  head = next;
+  return (true);
+}
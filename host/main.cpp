@@ -0,0 +1,104 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * Runs the game on the host (see tools/host.py to build it)
+ * Watches the demo, then presses fire to play a game: firing every so often
+ * and wandering left and right, then typing in a name if it gets a high
+ * score. Every screen update is checked against the stand-in display (see
+ * host_panel.h), which stops everything if they don't match, so getting to
+ * the end means the display got everything it should have.
+ *
+ *   invaders [-s seconds] [-p seconds] [-c commands] [-t seconds]
+ *
+ *   -s  How long to run for, in game time (default 300)
+ *   -p  When to press fire in the demo to start a game (default 20, 0 never)
+ *   -c  Commands to type into the serial console (needs CONSOLE, see
+ *       console.h), with ; for enter
+ *   -t  When to start typing them (default 25)
+ *
+ * Prints whatever the game prints, a line each time the mode changes:
+ *   MODE <millis> <mode> <score>
+ * and the display traffic at the end (see HostPanel::report - or for SPI,
+ *   SPI UPDATES <checks> COMMANDS <bytes> DATA <bytes> WIRE <ms> AT <kHz>)
+ */
+#include <stdio.h>
+#include <unistd.h>
+#include "hal.h"
+#include "hardware.h"
+#include "host_panel.h"
+#include "modes.h"
+
+#define HOST_TYPE_GAP 40            // Milliseconds between characters typed into the console
+
+// The sketch
+void setup ();
+void loop ();
+extern uint8_t mode;
+extern uint16_t score;
+
+/*
+ * The buttons held down, for the mode the game is in
+ */
+static uint8_t buttons (unsigned long now, unsigned long press) {
+  switch (mode) {
+    case MODE_DEMO:
+      return (press && now >= press && now < press + 1000 ? FIRE_BIT : 0);
+    case MODE_GAME:
+      // Fire every so often, and go back and forth
+      return (((now / 700) % 3 == 0 ? FIRE_BIT : 0) | ((now / 3000) % 2 ? LEFT_BIT : RIGHT_BIT));
+    case MODE_HIGH_SCORE:
+      return ((now / 300) % 2 ? FIRE_BIT : 0);
+  }
+  return (0);
+}
+
+int main (int argc, char *argv[]) {
+  unsigned long end = 300000;
+  unsigned long press = 20000;
+  const char *typing = "";
+  unsigned long typeAt = 25000;
+  int option;
+  while ((option = getopt (argc, argv, "s:p:c:t:")) != -1) {
+    switch (option) {
+      case 's': end = atol (optarg) * 1000; break;
+      case 'p': press = atol (optarg) * 1000; break;
+      case 'c': typing = optarg; break;
+      case 't': typeAt = atol (optarg) * 1000; break;
+      default:
+        fprintf (stderr, "usage: %s [-s seconds] [-p seconds] [-c commands] [-t seconds]\n", argv[0]);
+        return (1);
+    }
+  }
+
+  setup ();
+  uint8_t lastMode = 0xFF;
+  while (Clock::millis () < end) {
+    unsigned long now = Clock::millis ();
+    Buttons::set (buttons (now, press));
+    // Type the next character, if it's time
+    if (*typing && now >= typeAt) {
+      if (Serial.receive (*typing == ';' ? '\n' : *typing)) typing ++;
+      typeAt = now + HOST_TYPE_GAP;
+    }
+    loop ();
+    if (mode != lastMode) {
+      printf ("MODE %lu %u %u\n", Clock::millis (), mode, (unsigned)score * 10);
+      lastMode = mode;
+    }
+  }
+  if (Spi::bytesSent) {
+    printf ("SPI UPDATES %lu COMMANDS %lu DATA %lu WIRE %lums AT %lukHz\n", hostPanel.updates, hostPanel.commandBytes,
+      hostPanel.dataBytes, (Spi::bytesSent * 8000UL) / Spi::speed, (unsigned long)(Spi::speed / 1000));
+  } else {
+    hostPanel.report (I2c::speed);
+  }
+  return (0);
+}
@@ -0,0 +1,27 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef crc16_h
+#define crc16_h
+#include <stdint.h>
+
+/*
+ * The CRC from avr-libc's util/crc16.h, for the host (see host/Arduino.h)
+ * The same polynomial (0xA001, reflected), so the host and the Arduino agree.
+ */
+static inline uint16_t _crc16_update (uint16_t crc, uint8_t a) {
+  crc ^= a;
+  for (uint8_t i = 0; i < 8; i ++) {
+    crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : (crc >> 1);
+  }
+  return (crc);
+}
+
+#endif
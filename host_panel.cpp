@@ -0,0 +1,194 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * The stand-in display for the host (see host_panel.h)
+ * Only built for the host, like hal_host.cpp.
+ * The commands decoded are the ones in SSD1306.h (the SSD1309 and SH1106
+ * take the same ones). Anything else with arguments is skipped properly,
+ * but otherwise ignored.
+ */
+#ifdef HAL_HOST
+#include <stdio.h>
+#include <stdlib.h>
+#include "host_panel.h"
+#include "SSD1306.h"
+
+HostPanel hostPanel;
+
+/*
+ * Power up. The memory starts off full of junk, so anything that's never
+ * sent shows up.
+ */
+HostPanel::HostPanel () {
+  memset (ram, 0xA5, sizeof (ram));
+  mode = 2;
+  columnEnd = 127;
+  pageEnd = HOST_PANEL_PAGES - 1;
+}
+
+/*
+ * An I2C transmission
+ * Each control byte says whether commands or data follow. With Co set, only
+ * the next byte does, then there's another control byte.
+ */
+void HostPanel::i2c (uint8_t address, const uint8_t *bytes, uint8_t length) {
+  transactions ++;
+  HostPanel::bytes += length + 1;
+  if (address != OLED_ADDR) return;
+  uint8_t i = 0;
+  while (i < length) {
+    uint8_t control = bytes[i ++];
+    uint8_t end = (control & 0x80) ? min (i + 1, length) : length;
+    while (i < end) {
+      if (control & 0x40) {
+        data (bytes[i ++]);
+      } else {
+        command (bytes[i ++]);
+      }
+    }
+  }
+}
+
+/*
+ * An SPI byte (the D/C pin says which it is)
+ */
+void HostPanel::spi (boolean isData, uint8_t b) {
+  if (isData) {
+    data (b);
+  } else {
+    command (b);
+  }
+}
+
+/*
+ * A command byte, or an argument of the one before
+ */
+void HostPanel::command (uint8_t c) {
+  commandBytes ++;
+  if (arguments) {
+    arguments --;
+    switch (pending) {
+      case SSD1306_MEMORYMODE:
+        mode = c & 3;
+        break;
+      case SSD1306_COLUMNADDR:
+        if (arguments) {
+          column = columnStart = c;
+        } else {
+          columnEnd = c;
+        }
+        break;
+      case SSD1306_PAGEADDR:
+        if (arguments) {
+          page = pageStart = c & 7;
+        } else {
+          pageEnd = c & 7;
+        }
+        break;
+    }
+    return;
+  }
+  pending = c;
+  if (c < 0x10) {
+    column = (column & 0xF0) | c;
+  } else if (c < 0x20) {
+    column = (column & 0x0F) | ((c & 0x0F) << 4);
+  } else if ((c & 0xF8) == SSD1306_SETSTARTPAGE) {
+    page = c & 7;
+  } else {
+    switch (c) {
+      case SSD1306_COLUMNADDR:
+      case SSD1306_PAGEADDR:
+        arguments = 2;
+        break;
+      case SSD1306_MEMORYMODE:
+      case SSD1306_SETCONTRAST:
+      case SSD1306_SETMULTIPLEX:
+      case SSD1306_SETDISPLAYOFFSET:
+      case SSD1306_SETDISPLAYCLOCKDIV:
+      case SSD1306_SETPRECHARGE:
+      case SSD1306_SETCOMPINS:
+      case SSD1306_SETVCOMDETECT:
+      case SSD1306_CHARGEPUMP:
+      case SH1106_DCDC:
+        arguments = 1;
+        break;
+    }
+  }
+}
+
+/*
+ * Write a byte to display memory, and move on according to the addressing mode
+ */
+void HostPanel::data (uint8_t d) {
+  dataBytes ++;
+  if (column < HOST_PANEL_COLUMNS) ram[page][column] = d;
+  switch (mode) {
+    case 0:
+      // Horizontal - along the page, then on to the next
+      if (column ++ >= columnEnd) {
+        column = columnStart;
+        page = (page >= pageEnd) ? pageStart : page + 1;
+      }
+      break;
+    case 1:
+      // Vertical - down the column, then on to the next
+      if (page ++ >= pageEnd) {
+        page = pageStart;
+        column = (column >= columnEnd) ? columnStart : column + 1;
+      }
+      break;
+    default:
+      // Page - along the page, wrapping round at the end
+      if (++ column >= HOST_PANEL_COLUMNS) column = 0;
+  }
+}
+
+/*
+ * A byte of display memory
+ */
+uint8_t HostPanel::read (uint8_t page, uint8_t column) {
+  return (ram[page][column]);
+}
+
+/*
+ * Make sure the screen shows what's in the buffer, and stop if it doesn't
+ */
+void HostPanel::check (const uint8_t *buffer, uint8_t first, uint8_t pages, uint8_t width, uint8_t offset) {
+  updates ++;
+  for (uint8_t p = first; p < first + pages; p ++) {
+    for (uint8_t x = 0; x < width; x ++) {
+      uint8_t want = buffer[((p - first) * width) + x];
+      if (ram[p][x + offset] != want) {
+        fprintf (stderr, "PANEL MISMATCH update %lu page %u column %u screen %02X buffer %02X\n", updates, p, x, ram[p][x + offset], want);
+        abort ();
+      }
+    }
+  }
+}
+
+/*
+ * How long the I2C traffic would take - 9 clocks a byte (with the ack), and
+ * about 2 more for the start and stop of each transmission
+ */
+unsigned long HostPanel::wireTime (uint32_t clock) {
+  return ((unsigned long)(((bytes * 9.0) + (transactions * 2.0)) * 1000000.0 / clock));
+}
+
+/*
+ * Print the counts, and the time on the wire at the given clock
+ */
+void HostPanel::report (uint32_t clock) {
+  printf ("PANEL UPDATES %lu TRANSACTIONS %lu BYTES %lu COMMANDS %lu DATA %lu WIRE %lums AT %lukHz\n",
+    updates, transactions, bytes, commandBytes, dataBytes, wireTime (clock) / 1000, (unsigned long)(clock / 1000));
+}
+
+#endif
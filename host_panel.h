@@ -0,0 +1,60 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef host_panel_h
+#define host_panel_h
+#include <Arduino.h>
+
+/*
+ * A stand-in for the display when running on the host (HAL_HOST)
+ * Everything sent over I2C or SPI is decoded the way the controller would,
+ * into its display memory, so the screen can be checked without a panel.
+ * The driver checks it against the screen buffer after every update (or the
+ * strip, after each page, in strip mode), which catches anything that changes
+ * the buffer without sending it.
+ * It also counts the traffic, and works out how long it would take on the
+ * wire at a given I2C clock.
+ */
+
+#define HOST_PANEL_PAGES 8
+#define HOST_PANEL_COLUMNS 132        // Enough for an SH1106
+
+class HostPanel {
+  public:
+    HostPanel ();
+    void i2c (uint8_t address, const uint8_t *data, uint8_t length);  // An I2C transmission
+    void spi (boolean data, uint8_t b);             // A byte over SPI (data or command)
+    uint8_t read (uint8_t page, uint8_t column);    // A byte of display memory
+    void check (const uint8_t *buffer, uint8_t first, uint8_t pages, uint8_t width, uint8_t offset);  // Stop if the screen doesn't match the buffer
+    unsigned long wireTime (uint32_t clock);        // Microseconds the I2C traffic would have taken
+    void report (uint32_t clock);                   // Print the traffic counts
+
+    unsigned long transactions;                     // I2C transmissions
+    unsigned long bytes;                            // I2C bytes, including the address
+    unsigned long commandBytes;                     // Commands and their arguments
+    unsigned long dataBytes;                        // Bytes written to display memory
+    unsigned long updates;                          // Checks made
+
+  private:
+    void command (uint8_t c);
+    void data (uint8_t d);
+    uint8_t ram[HOST_PANEL_PAGES][HOST_PANEL_COLUMNS];
+    uint8_t column;
+    uint8_t page;
+    uint8_t mode;                                   // Memory addressing mode (0 horizontal, 1 vertical, 2 page)
+    uint8_t columnStart, columnEnd;                 // The window for horizontal and vertical addressing
+    uint8_t pageStart, pageEnd;
+    uint8_t pending;                                // The command waiting for its arguments
+    uint8_t arguments;                              // How many more it wants
+};
+
+extern HostPanel hostPanel;
+
+#endif
@@ -0,0 +1,115 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * Button handling
+ * Rather than polling the buttons with digitalRead () (which is slow and
+ * can miss a quick tap if the loop is busy updating the screen), the buttons
+ * trigger a pin change interrupt. The interrupt reads the port directly,
+ * debounces the buttons and adds an event to a queue for each press and
+ * release, stamped with the time it happened.
+ * Debouncing works by ignoring a button for a short while after it changes.
+ * If it was bouncing, the last bounce could leave it in a different state to
+ * the one recorded, with no further interrupt to put things right, so the
+ * main loop calls poll () to catch up.
+ */
+#include "input.h"
+
+Input input;
+
+// The port bits for each button, in button order
+const uint8_t buttonBits[] = { LEFT_BIT, RIGHT_BIT, FIRE_BIT };
+
+/*
+ * Set up the pins and start the interrupt
+ */
+void Input::init () {
+  Buttons::init ();
+  // Let the pins settle
+  Clock::delay (1);
+  // Take the buttons as they are (no events for buttons held at power up)
+  uint8_t pins = Buttons::read ();
+  uint8_t button = 1;
+  state = 0;
+  for (uint8_t i = 0; i < 3; i ++) {
+    if (pins & buttonBits[i]) state |= button;
+    button = button << 1;
+  }
+  head = tail = 0;
+  Buttons::enableInterrupt ();
+}
+
+/*
+ * Read the buttons and queue an event for any that have changed
+ * Called with interrupts off
+ */
+void Input::pinChange () {
+  unsigned long now = Clock::micros ();
+  uint8_t pins = Buttons::read ();
+  uint8_t button = 1;
+  for (uint8_t i = 0; i < 3; i ++) {
+    boolean pressed = pins & buttonBits[i];
+    // Has it changed, and has it been left alone long enough to believe it?
+    if (pressed != (boolean)(state & button) && now - lastChange[i] >= INPUT_DEBOUNCE) {
+      state ^= button;
+      lastChange[i] = now;
+      uint8_t next = (head + 1) & (INPUT_QUEUE_SIZE - 1);
+      // If the queue is full, the event is lost (but the state is still right)
+      if (next != tail) {
+        queue[head].button = button;
+        queue[head].pressed = pressed;
+        queue[head].time = now;
+        head = next;
+      }
+    }
+    button = button << 1;
+  }
+}
+
+/*
+ * Take the oldest event from the queue
+ * Returns false if there are none waiting
+ */
+boolean Input::getEvent (InputEvent &e) {
+  if (head == tail) return (false);
+  e = queue[tail];
+  tail = (tail + 1) & (INPUT_QUEUE_SIZE - 1);
+  return (true);
+}
+
+/*
+ * The debounced state of the buttons
+ */
+uint8_t Input::held () {
+  return (state);
+}
+
+/*
+ * Pick up anything the interrupt ignored while debouncing
+ */
+void Input::poll () {
+  noInterrupts ();
+  pinChange ();
+  interrupts ();
+}
+
+/*
+ * Throw away any waiting events
+ */
+void Input::flush () {
+  tail = head;
+}
+
+/*
+ * The pin change interrupt
+ */
+HAL_ISR (HAL_BUTTONS_VECT) {
+  input.pinChange ();
+}
@@ -0,0 +1,52 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef input_h
+#define input_h
+#include <Arduino.h>
+#include "hal.h"
+
+// Buttons
+#define BUTTON_LEFT 1
+#define BUTTON_RIGHT 2
+#define BUTTON_FIRE 4
+
+#define INPUT_DEBOUNCE 5000 // Time in microseconds to ignore a button after it changes
+#define INPUT_QUEUE_SIZE 8  // The number of button events that can be waiting (must be a power of 2)
+
+/*
+ * A button being pressed or released, and when
+ */
+struct InputEvent {
+  uint8_t button;           // The button that changed
+  boolean pressed;          // True if pressed, false if released
+  unsigned long time;       // micros () at the time of the change
+};
+
+class Input {
+  public:
+    void init ();                       // Set up the pins and start the interrupt
+    boolean getEvent (InputEvent &e);   // Get the oldest waiting event - returns false if there are none
+    uint8_t held ();                    // The (debounced) buttons currently held down
+    void poll ();                       // Catch up with any change that was ignored while debouncing
+    void flush ();                      // Throw away any waiting events
+    void pinChange ();                  // Read the buttons (called by the interrupt)
+
+  private:
+    volatile uint8_t state;             // The debounced button state
+    volatile uint8_t head;              // Where the next event will be added to the queue
+    volatile uint8_t tail;              // Where the next event will be taken from the queue
+    InputEvent queue[INPUT_QUEUE_SIZE];
+    unsigned long lastChange[3];        // When each button last changed (micros)
+};
+
+extern Input input;
+
+#endif
@@ -0,0 +1,102 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * Button to screen latency measurement
+ * A measurement goes through three stages:
+ * 1. The button is pressed. The time comes from the input interrupt, so it's
+ *    when the button was really pressed, not when the loop noticed.
+ * 2. The base or laser is drawn into the screen buffer in response.
+ * 3. The page of the screen buffer it was drawn into has been sent to the
+ *    display. That's as close to the player seeing it as we can get.
+ * Anything in between (countdowns, the order things happen in the loop,
+ * other pages being sent first) is counted.
+ * Only enabled when LATENCY_PROBE is defined in latency.h
+ */
+#include "latency.h"
+
+#ifdef LATENCY_PROBE
+
+#define LATENCY_IDLE 0         // Nothing being measured
+#define LATENCY_PRESSED 0xFF    // Waiting for the response to be drawn (otherwise, waiting for page - 1 to be sent)
+
+Latency latency;
+
+/*
+ * A button was pressed (a new press replaces one that never got a response)
+ */
+void Latency::edge (uint8_t probe, unsigned long time) {
+  pressTime[probe] = time;
+  waiting[probe] = LATENCY_PRESSED;
+}
+
+/*
+ * The response to a press was drawn
+ */
+void Latency::drawn (uint8_t probe, uint8_t y) {
+  if (waiting[probe] == LATENCY_PRESSED) {
+    waiting[probe] = (y / 8) + 1;
+  }
+}
+
+/*
+ * A page has been sent, so anything drawn into it has now arrived
+ */
+void Latency::pageSent (uint8_t page) {
+  for (uint8_t i = 0; i < LATENCY_PROBES; i ++) {
+    if (waiting[i] == page + 1) {
+      unsigned long taken = Clock::micros () - pressTime[i];
+      // Find the bucket (1ms, 2ms, 4ms...)
+      uint8_t bucket = 0;
+      for (unsigned long ms = taken >> 10; ms && bucket < LATENCY_BUCKETS - 1; ms = ms >> 1) {
+        bucket ++;
+      }
+      histogram[i][bucket] ++;
+      total[i] += taken;
+      if (taken > worst[i]) worst[i] = taken;
+      waiting[i] = LATENCY_IDLE;
+    }
+  }
+}
+
+/*
+ * Print the histograms over the serial port and start again
+ * Format, per probe:
+ * LATENCY FIRE N 12 AVG 5123 MAX 9000
+ * <1 0 <2 3 <4 5 <8 2 <16 2 <32 0 <64 0 >64 0
+ * (times in microseconds, buckets in milliseconds)
+ */
+void Latency::report () {
+  for (uint8_t i = 0; i < LATENCY_PROBES; i ++) {
+    uint16_t count = 0;
+    for (uint8_t j = 0; j < LATENCY_BUCKETS; j ++) {
+      count += histogram[i][j];
+    }
+    Serial.print (i == LATENCY_FIRE ? F("LATENCY FIRE N ") : F("LATENCY MOVE N "));
+    Serial.print (count);
+    Serial.print (F(" AVG "));
+    Serial.print (count ? total[i] / count : 0);
+    Serial.print (F(" MAX "));
+    Serial.println (worst[i]);
+    for (uint8_t j = 0; j < LATENCY_BUCKETS; j ++) {
+      Serial.print (j == LATENCY_BUCKETS - 1 ? '>' : '<');
+      Serial.print (1 << (j == LATENCY_BUCKETS - 1 ? j - 1 : j));
+      Serial.print (' ');
+      Serial.print (histogram[i][j]);
+      Serial.print (' ');
+      histogram[i][j] = 0;
+    }
+    Serial.println ();
+    total[i] = worst[i] = 0;
+    waiting[i] = LATENCY_IDLE;
+  }
+}
+
+#endif
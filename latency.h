@@ -0,0 +1,63 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef latency_h
+#define latency_h
+#include <Arduino.h>
+#include "hal.h"
+
+/*
+ * Uncomment to measure the time from a button press to its effect reaching
+ * the screen. The results are printed over the serial port at game over.
+ */
+//#define LATENCY_PROBE
+
+// What is being measured
+#define LATENCY_FIRE 0      // Fire button to laser appearing
+#define LATENCY_MOVE 1      // Left / right button to base moving
+#define LATENCY_PROBES 2
+
+#define LATENCY_BUCKETS 8   // Histogram buckets, doubling from 1ms (the last one catches everything else)
+
+#ifdef LATENCY_PROBE
+
+class Latency {
+  public:
+    void edge (uint8_t probe, unsigned long time);  // A button was pressed at the given time (micros)
+    void drawn (uint8_t probe, uint8_t y);          // The response has been drawn into the screen buffer at y
+    void pageSent (uint8_t page);                   // A page of the screen buffer has been sent to the display
+    void report ();                                 // Print the results and start again
+
+  private:
+    uint8_t waiting[LATENCY_PROBES];                // LATENCY_IDLE, LATENCY_PRESSED or the page waiting to be sent + 1
+    unsigned long pressTime[LATENCY_PROBES];
+    uint16_t histogram[LATENCY_PROBES][LATENCY_BUCKETS];
+    unsigned long total[LATENCY_PROBES];            // For the average
+    unsigned long worst[LATENCY_PROBES];
+};
+
+extern Latency latency;
+
+#define LATENCY_EDGE(probe, time) latency.edge (probe, time)
+#define LATENCY_DRAWN(probe, y) latency.drawn (probe, y)
+#define LATENCY_SENT(page) latency.pageSent (page)
+#define LATENCY_REPORT() latency.report ()
+
+#else
+
+// Statements that do nothing, so they're still safe on their own after an if
+#define LATENCY_EDGE(probe, time) do {} while (0)
+#define LATENCY_DRAWN(probe, y) do {} while (0)
+#define LATENCY_SENT(page) do {} while (0)
+#define LATENCY_REPORT() do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,102 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef modes_h
+#define modes_h
+#include <Arduino.h>
+
+/*
+ * The top level modes
+ * Only one of these runs at a time, so they all share the same bit of RAM
+ * (see ModeState below). Entering a mode clears it, so anything not set
+ * when the mode starts is zero.
+ */
+#define MODE_DEMO 0           // The title screens and attract animation
+#define MODE_GAME 1           // Playing a game
+#define MODE_GAME_OVER 2      // Showing the GAME OVER message
+#define MODE_HIGH_SCORE 3     // Typing in a name for the high score table
+#define MODE_DEMO_PLAY 4      // The demo playing a game, following a script
+
+/*
+ * The most RAM the mode state may use, in bytes on the AVR. This is what the
+ * game variables that the demo and high score entry used to borrow took up
+ * (nine 2 byte ints, a 4 byte long, the lives, the level, two flags and the
+ * three letter high score name), less a byte for the mode itself. So the
+ * modes use no more RAM than they did before.
+ */
+#define MODE_STATE_LIMIT 28
+
+/*
+ * Playing a game (or the demo playing it)
+ */
+struct GameState {
+  long mysteryCreateCountdown; // Countdown until the next mystery ship appears (only valid when mysteryArmed is set)
+  int alienStepCountdown;     // Countdown till the next alien step
+  int baseMoveCountdown;      // Countdown until the base can move again
+  int laserMoveCountdown;     // Countdown until the laser moves again
+  int bombMoveCountdown;      // Countdown until the bombs can move again
+  int explosionCountdown;     // Countdown until the alien explosion is removed
+  int interLevelCountdown;    // Countdown until the next level starts
+  int baseDeadCountdown;      // Countdown until the base explosion sound stops
+  int mysteryMoveCountdown;   // Countdown until the mystery ship can move again
+  int mysteryHitCountdown;    // Countdown until the mystery score is removed
+  int demoEventCountdown;     // Countdown until the next event in the demo's script (demo only)
+  uint8_t level;              // Current level (starting at 1)
+  uint8_t lives;              // Lives remaining (including the current one)
+  boolean mysteryArmed;       // A mystery ship is allowed and the countdown is running
+  uint8_t demoEvent;          // The next event in the demo's script (demo only)
+};
+
+/*
+ * The demo
+ * When the demo plays the game, it switches to MODE_DEMO_PLAY, which uses
+ * the GameState like a real game.
+ */
+struct DemoState {
+  int stepCountdown;          // Countdown until the next step
+  uint8_t step;               // Where we are in the demo sequence
+  uint8_t slowTypeOffset;     // The next character to slow type
+  uint8_t alienX;             // Where the alien pulling the Y about is
+};
+
+/*
+ * The game over message
+ */
+struct GameOverState {
+  int countdown;              // Countdown until the message is removed
+};
+
+/*
+ * High score entry
+ */
+struct HighScoreState {
+  int flashCountdown;         // Countdown until the next character flashes on or off
+  uint8_t name[3];            // The name typed so far
+  uint8_t namePtr;            // The next character of the name
+  int8_t cursorX;             // The cursor position in the character grid
+  int8_t cursorY;
+  uint8_t nameX;              // Where the next character of the name goes on the screen
+  boolean flashOn;            // The next character is showing
+  boolean buttonReleased;     // All the buttons have been let go since the last press
+};
+
+union ModeState {
+  GameState game;
+  DemoState demo;
+  GameOverState gameOver;
+  HighScoreState highScore;
+};
+
+// Only checked on the AVR - ints and longs are bigger on the host (HAL_HOST)
+#ifndef HAL_HOST
+static_assert (sizeof (ModeState) <= MODE_STATE_LIMIT, "The mode state uses more RAM than it used to");
+#endif
+
+#endif
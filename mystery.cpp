@@ -9,65 +9,114 @@
 *                                                                              *
 *******************************************************************************/
 #include "mystery.h"
+#include "trace.h"
+/*
+ * When the ship is hit, its score is shown where it was until destroy () is
+ * called, so ship_x stays put and points is set.
+ */
 
-void Mystery::init (SSD1306 &screen) {
+void Mystery::init () {
   // Pick a randon direction
-  movingRight = random (2);
+  movingRight = gameRandom.below (2);
   // Set the start position
   ship_x = movingRight ? 0 : 119;
-  // Draw the ship on the screen
-  screen.drawBitmap (BM_MYSTERY, ship_x, SHIP_Y);
+  points = 0;
+}
+
+/*
+ * Draw the ship, if there is one
+ */
+void Mystery::draw (SSD1306 &screen) {
+  if (exists ()) {
+    screen.drawSprite (BM_MYSTERY, ship_x, SHIP_Y);
+  }
 }
 
 boolean Mystery::exists () {
-  return (ship_x < SHIP_HIT);
+  return (ship_x != NO_SHIP && !points);
 }
 
 boolean Mystery::canCreateNew () {
   return (ship_x == NO_SHIP);
 }
 
-void Mystery::move (SSD1306 &screen) {
-  // Clear the space where the ship was
-  screen.clearRect (ship_x, SHIP_Y, 9, 5);
+void Mystery::move () {
   // Move the ship 1 pixel in its chosen direction
   ship_x += movingRight ? 1 : -1;
   // If the ship hits the right edge of the screen (NOTE. Ships moving left will automatically hit the NO_SHIP value)
   if (ship_x > 119) {
     // The ship has gone
     ship_x = NO_SHIP;
-  } else {
-    // Draw the ship in its new position
-    screen.drawBitmap (BM_MYSTERY, ship_x, SHIP_Y);
   }
 }
 
-uint16_t Mystery::collisionDetect (SSD1306 &screen, uint8_t x, uint8_t y) {
+uint16_t Mystery::collisionDetect (uint8_t x, uint8_t y) {
+  TRACE_SCOPE (TRACE_MYSTERY_COLLISION);
   // If the ship exists and the laser Y coordinate is in the mystery fly zone
-  if (ship_x < SHIP_HIT && y < SHIP_Y + 5) {
+  if (exists () && y < SHIP_Y + 5) {
     // If the laser X coordinate is wihin the mystery ship's position
     if (x >= ship_x && x <= ship_x + 9) {
-      // Erase the ship
-      screen.clearRect (ship_x, SHIP_Y, 9, 5);
-      // Generate a random score between 50 and 300
-      uint16_t score = random (1, 7) * 50;
-      // Set the cursor to the ship's position
-      screen.setCursor (ship_x + (score > 99 ? max (-ship_x, -2) : 0), SHIP_Y);
-      // Put the score on the screen
-      screen.writeInt (score);
-      // Mark the ship as hit
-      ship_x = SHIP_HIT;
+      // Generate a random score between 50 and 300 (which also marks the ship as hit)
+      points = gameRandom.range (1, 7);
       // Return the shore
-      return (score);
+      return (points * 50);
     }
   }
   return (0);
 }
 
 boolean Mystery::wasHit () {
-  return (ship_x == SHIP_HIT);
+  return (points != 0);
 }
 
 void Mystery::destroy () {
   ship_x = NO_SHIP;
+  points = 0;
+}
+
+/*
+ * Has the ship changed since it was last drawn?
+ */
+boolean Mystery::changed () {
+  return (drawn_x != ship_x || drawnPoints != points);
+}
+
+/*
+ * Rub out the ship, or its score, where it was last drawn
+ */
+void Mystery::erase (SSD1306 &screen) {
+  if (changed ()) {
+    if (drawnPoints) {
+      // Clear the whole top line.... fuck it!
+      screen.clearRect (0, SHIP_Y, SSD1306_LCDWIDTH, 5);
+    } else if (drawn_x != NO_SHIP) {
+      screen.clearRect (drawn_x, SHIP_Y, 9, 5);
+    }
+  }
+}
+
+/*
+ * Draw the ship, or its score if it's been hit, where it is now
+ */
+void Mystery::show (SSD1306 &screen) {
+  if (changed ()) {
+    if (points) {
+      uint16_t score = points * 50;
+      // Put the score where the ship was
+      screen.setCursor (ship_x + (score > 99 ? max (-ship_x, -2) : 0), SHIP_Y);
+      screen.writeInt (score);
+    } else {
+      draw (screen);
+    }
+    drawn_x = ship_x;
+    drawnPoints = points;
+  }
+}
+
+/*
+ * The screen has been cleared
+ */
+void Mystery::offScreen () {
+  drawn_x = NO_SHIP;
+  drawnPoints = 0;
 }
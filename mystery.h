@@ -13,24 +13,33 @@
 
 #include "SSD1306.h"
 #include "bitmaps.h"
+#include "rng.h"
 
 #define SHIP_Y 6
 #define NO_SHIP 255
-#define SHIP_HIT 254
 
 class Mystery {
   public:
-    void init (SSD1306 &screen);
-    void move (SSD1306 &screen);
-    uint16_t collisionDetect (SSD1306 &screen, uint8_t x, uint8_t y);
+    void init ();
+    void move ();
+    void draw (SSD1306 &screen);
+    uint16_t collisionDetect (uint8_t x, uint8_t y);
     boolean exists ();
     boolean wasHit ();
     void destroy ();
     boolean canCreateNew ();
+    void erase (SSD1306 &screen);   // Rub out the ship (or its score) where it was last drawn, if it's changed
+    void show (SSD1306 &screen);    // ... and draw it where it is now
+    void offScreen ();              // The screen has been cleared, so draw it from scratch next time
     
   private:
+    boolean changed ();
     uint8_t ship_x = NO_SHIP;
     boolean movingRight;
+    uint8_t points;                 // The score for hitting it / 50 (zero until it's hit)
+    // What's on the screen
+    uint8_t drawn_x = NO_SHIP;
+    uint8_t drawnPoints;
 };
 
 #endif
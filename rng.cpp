@@ -0,0 +1,84 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * A small, fast random number generator.
+ * Arduino's random () is a 32 bit LCG followed by a modulo, which on an 8 bit
+ * AVR means a long multiply and a long division every time it's called. And
+ * it gets called a lot.
+ * This is a 16 bit xorshift generator (shift triple 7, 9, 8), which boils down
+ * to a handful of shifts and exclusive ORs. The period is 65535, which is
+ * plenty for a game of Space Invaders.
+ * Bounded values are produced by multiplying rather than dividing. The 16 bit
+ * random value is treated as a fraction of 65536 and multiplied by the range,
+ * keeping the top 16 bits. The AVR has a hardware multiplier, so this is cheap.
+ */
+#include "rng.h"
+
+Rng gameRandom (RNG_SEED_GAME);
+Rng effectsRandom (RNG_SEED_EFFECTS);
+Rng soundRandom (RNG_SEED_SOUND);
+
+/*
+ * Restart the stream
+ * A zero state would get stuck at zero forever, so it is not allowed
+ */
+void Rng::seed (uint16_t s) {
+  state = s ? s : RNG_SEED_GAME;
+}
+
+/*
+ * Move the stream on and return the new value
+ */
+uint16_t Rng::next () {
+  uint16_t x = state;
+  x ^= x << 7;
+  x ^= x >> 9;
+  x ^= x << 8;
+  state = x;
+  return (x);
+}
+
+/*
+ * Return a value between 0 and n - 1 (no division required)
+ */
+uint16_t Rng::below (uint16_t n) {
+  return (((uint32_t)next () * n) >> 16);
+}
+
+/*
+ * Return a value between lo and hi - 1
+ */
+int16_t Rng::range (int16_t lo, int16_t hi) {
+  return (lo + (int16_t)below (hi - lo));
+}
+
+/*
+ * Return a random waiting time for an event that is equally likely to happen
+ * at any moment, with an average wait of mean.
+ * That's -ln (U) * mean, with U uniform between 0 and 1. To keep the floating
+ * point library out of it, log2 is approximated with a straight line between
+ * powers of two (the position of the top bit gives the whole part, the bits
+ * beneath it the fraction), and the result is scaled by ln (2) ~= 177 / 256.
+ * The approximation is out by less than 0.09 at worst, which nobody will
+ * notice when waiting for a mystery ship.
+ */
+uint32_t Rng::interval (uint16_t mean) {
+  uint16_t u = next ();
+  uint8_t whole = 15;
+  // Normalise so that the top bit is set, counting the shifts
+  while (!(u & 0x8000)) {
+    u = u << 1;
+    whole --;
+  }
+  // -log2 (u / 65536) in 8.8 fixed point (between 1/256 and 16)
+  uint16_t negLog = (16 << 8) - ((whole << 8) | ((u >> 7) & 0xFF));
+  return (((((uint32_t)mean * negLog) >> 8) * 177) >> 8);
+}
@@ -0,0 +1,42 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef rng_h
+#define rng_h
+#include <Arduino.h>
+
+// Default seeds for each stream (any non-zero value will do)
+#define RNG_SEED_GAME 0xACE1
+#define RNG_SEED_EFFECTS 0x5EED
+#define RNG_SEED_SOUND 0xBEEF
+
+class Rng {
+  public:
+    Rng (uint16_t s) : state (s) {}
+    void seed (uint16_t s);             // Restart the stream from the given seed
+    uint16_t next ();                   // The next raw 16 bit value (never zero)
+    uint16_t below (uint16_t n);        // A value from 0 to n - 1
+    int16_t range (int16_t lo, int16_t hi); // A value from lo to hi - 1 (same as Arduino's random (lo, hi))
+    uint32_t interval (uint16_t mean);  // A random waiting time (exponentially distributed) with the given mean
+
+  private:
+    uint16_t state;
+};
+
+/*
+ * The random number streams
+ * Each subsystem has its own stream, so that (for example) the number of
+ * times the sound engine draws a number doesn't alter the game play.
+ */
+extern Rng gameRandom;      // Game play - bombs, mystery ship, alien columns
+extern Rng effectsRandom;   // Visual effects - defence damage
+extern Rng soundRandom;     // Sound - laser hiss and explosion noise
+
+#endif
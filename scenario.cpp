@@ -0,0 +1,87 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * Worst case scenario measurement
+ * Counts the time each frame takes and the bytes it sends to the display,
+ * and in strip mode the time each page takes to draw, and prints the
+ * average and worst of them. The scenarios themselves are
+ * in Invaders.ino, as they need to get at the game.
+ * Only enabled when SCENARIO_BENCH is defined in scenario.h
+ */
+#include "scenario.h"
+
+#ifdef SCENARIO_BENCH
+
+Scenario scenario;
+
+void Scenario::start () {
+  frames = 0;
+  cpuTotal = cpuWorst = 0;
+  bytesTotal = bytesWorst = 0;
+  pages = 0;
+  renderTotal = renderWorst = 0;
+}
+
+void Scenario::frameStart () {
+  busBytes = 0;
+  frameTime = Clock::cpuMicros ();
+}
+
+void Scenario::frameEnd () {
+  unsigned long taken = Clock::cpuMicros () - frameTime;
+  frames ++;
+  cpuTotal += taken;
+  if (taken > cpuWorst) cpuWorst = taken;
+  bytesTotal += busBytes;
+  if (busBytes > bytesWorst) bytesWorst = busBytes;
+}
+
+void Scenario::renderStart () {
+  renderTime = Clock::cpuMicros ();
+}
+
+void Scenario::renderEnd () {
+  unsigned long taken = Clock::cpuMicros () - renderTime;
+  pages ++;
+  renderTotal += taken;
+  if (taken > renderWorst) renderWorst = taken;
+}
+
+/*
+ * Print the results over the serial port
+ * Format:
+ * SCENARIO march FRAMES 40 CPU 2100 5400 BYTES 350 1161 PAGES 0 RENDER 0 0
+ * (the average and worst, times in microseconds, bytes as they go over the
+ * bus, including the I2C address and control bytes, then the number of
+ * pages drawn and the time each took - strip mode only)
+ */
+void Scenario::report (const __FlashStringHelper *name) {
+  Serial.print (F("SCENARIO "));
+  Serial.print (name);
+  Serial.print (F(" FRAMES "));
+  Serial.print (frames);
+  Serial.print (F(" CPU "));
+  Serial.print (frames ? cpuTotal / frames : 0);
+  Serial.print (' ');
+  Serial.print (cpuWorst);
+  Serial.print (F(" BYTES "));
+  Serial.print (frames ? bytesTotal / frames : 0);
+  Serial.print (' ');
+  Serial.print (bytesWorst);
+  Serial.print (F(" PAGES "));
+  Serial.print (pages);
+  Serial.print (F(" RENDER "));
+  Serial.print (pages ? renderTotal / pages : 0);
+  Serial.print (' ');
+  Serial.println (renderWorst);
+}
+
+#endif
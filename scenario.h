@@ -0,0 +1,71 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef scenario_h
+#define scenario_h
+#include <Arduino.h>
+#include "hal.h"
+
+/*
+ * Uncomment to run the worst case scenarios when the game starts up (see the
+ * end of Invaders.ino). Each one sets up a busy bit of the game, forces
+ * everything in it to happen every frame, and prints how long the frames
+ * took and how much was sent to the display. The same scenarios run the
+ * same way on the Arduino and with the host backend, so the results can be
+ * put side by side (see tools/scenario_compare.py). On the host, there's no
+ * need to uncomment it:
+ *   tools/host.py -D SCENARIO_BENCH --run -- -s 1
+ * After they've all run, the demo starts as normal.
+ */
+//#define SCENARIO_BENCH
+#define SCENARIO_FRAMES 40        // Frames measured in each scenario
+#define SCENARIO_SEED 1978        // The random numbers are the same every time
+
+#ifdef SCENARIO_BENCH
+
+class Scenario {
+  public:
+    void start ();                                  // Start measuring a scenario
+    void frameStart ();                             // A frame is starting
+    void frameEnd ();                               // ... and has finished
+    void sent (uint16_t bytes) { busBytes += bytes; } // Bytes have gone to the display (see SSD1306.cpp)
+    void renderStart ();                            // A page is being drawn in strip mode (see SSD1306.cpp)
+    void renderEnd ();                              // ... and has been
+    void report (const __FlashStringHelper *name);  // Print the results
+
+  private:
+    unsigned long frameTime;                        // When the frame started (Clock::cpuMicros)
+    unsigned long busBytes;                         // Bytes sent since the frame started
+    uint8_t frames;
+    unsigned long cpuTotal;                         // For the averages
+    unsigned long cpuWorst;
+    unsigned long bytesTotal;
+    unsigned long bytesWorst;
+    unsigned long renderTime;                       // When the page started (Clock::cpuMicros)
+    uint16_t pages;                                 // Pages drawn in strip mode
+    unsigned long renderTotal;
+    unsigned long renderWorst;
+};
+
+extern Scenario scenario;
+
+#define SCENARIO_SENT(bytes) scenario.sent (bytes)
+#define SCENARIO_RENDER_START() scenario.renderStart ()
+#define SCENARIO_RENDER_END() scenario.renderEnd ()
+
+#else
+
+#define SCENARIO_SENT(bytes)
+#define SCENARIO_RENDER_START()
+#define SCENARIO_RENDER_END()
+
+#endif
+
+#endif
@@ -10,189 +10,239 @@
 *******************************************************************************/
 /*
  * The sound capabilities of the Arduino are somewhat limited (without
- * additional hardware). Single channel PWM allows us to produce single beeps
- * of various frequencies with no control over amplitude. Having said that,
- * the original Space Invaders game, didn't have much better, although the
+ * additional hardware). A single PWM pin doesn't give us much to play with,
+ * although the original Space Invaders game didn't have much better. The
  * simple sound chips of that era were capable of multi-channel, plus white
  * noise.
- * I could have used several PWM pins and then, mixed the sound with external
- * circuitry. Sod that! I opted for the next best thing. The same technique
- * used in MP3 encoding... well... sort of. Use the human brain's limited 
- * capacity for processing.
- * Ok, that's a bit of a stretch, but the principle is the same. The system
- * here only plays one sound at a time, based on a priority. The most
- * important / "loudest" sounds have a higher priority. When there are several
- * sounds required simultaneously, only the highest priority one is played.
- * It works quite well considering the limitations.
+ * So, that's what we do here. Well... sort of. Timer 2 runs the PWM on the
+ * sound pin so fast (62.5 KHz) that the piezo only hears the average, which
+ * is set by the PWM duty. Timer 1 interrupts SOUND_SAMPLE_RATE times a
+ * second and works out what that average should be, by adding together
+ * several voices (direct digital synthesis). Each voice steps through a wave
+ * table in progmem at a speed that gives its frequency.
+ * This means the march, the laser and the mystery ship can all be heard at
+ * the same time. Sounds that share a voice still use the old priority
+ * system - the most important / "loudest" sound wins.
+ * Once a millisecond, the interrupt also updates each sound (sweeps, warbles,
+ * noise and so on), so nothing in the main loop has to look after them.
+ * Rather than writing code for each sound, they are all described by little
+ * scripts in progmem (see the SEQ_ instructions in sound.h), which the
+ * interrupt works through an instruction at a time. A new sound is just a
+ * few more bytes in the tables below.
+ * When nothing is playing, the interrupt switches itself off.
+ * With SOUND_TIMELINE defined, every sound starting and stopping (and with
+ * SOUND_TIMELINE_STEPS, every change of frequency the scripts make) is logged
+ * and printed over the serial port by the main loop (never the interrupt).
+ * Printing takes time, so the timing of the game itself will be a little
+ * different, but it is the same for every capture, which is what matters
+ * when comparing them. On the host (see tools/host.py) the log uses the
+ * virtual clock, and printing takes none of it, so nothing moves at all.
  */
 #include "sound.h"
+#include "trace.h"
+
+Sound sounds;
+
+/*
+ * Wave tables
+ */
+const uint8_t waveSquare[1 << SOUND_WAVE_BITS] PROGMEM = {
+  SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL,
+  SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL, SOUND_LEVEL,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// A buzzier wave for the low march notes
+const uint8_t waveSaw[1 << SOUND_WAVE_BITS] PROGMEM = {
+  85, 82, 80, 77, 74, 71, 69, 66, 63, 60, 58, 55, 52, 49, 47, 44,
+  41, 38, 36, 33, 30, 27, 25, 22, 19, 16, 14, 11, 8, 5, 3, 0
+};
+
+/*
+ * Sound effect scripts
+ */
+// The alien march - four notes, a different one each step (each note is two instructions)
+const SoundOp marchScript[] PROGMEM = {
+  { SEQ_TONE, SOUND_MARCH_COUNTDOWN, SOUND_STEP (SOUND_MARCH1_FREQ), 0 }, { SEQ_END, 0, 0, 0 },
+  { SEQ_TONE, SOUND_MARCH_COUNTDOWN, SOUND_STEP (SOUND_MARCH2_FREQ), 0 }, { SEQ_END, 0, 0, 0 },
+  { SEQ_TONE, SOUND_MARCH_COUNTDOWN, SOUND_STEP (SOUND_MARCH3_FREQ), 0 }, { SEQ_END, 0, 0, 0 },
+  { SEQ_TONE, SOUND_MARCH_COUNTDOWN, SOUND_STEP (SOUND_MARCH4_FREQ), 0 }, { SEQ_END, 0, 0, 0 }
+};
+
+// The laser sound is quite high frequency with a small random element.
+// This gives the sound a sort of hiss, like the original game.
+const SoundOp laserScript[] PROGMEM = {
+  { SEQ_NOISE, SOUND_LASER_COUNTDOWN, SOUND_STEP (SOUND_LASER_FREQ), SOUND_STEP (SOUND_LASER_HISS) }
+};
+
+// When aliens are shot they just produce a decending tone
+const SoundOp alienKilledScript[] PROGMEM = {
+  { SEQ_TONE, SOUND_ALIEN_COUNTDOWN, SOUND_STEP (SOUND_ALIEN_HIGH_FREQ), 0 },
+  { SEQ_SWEEP, SOUND_ALIEN_COUNTDOWN, -SOUND_STEP (SOUND_ALIEN_FREQ_STEP), SOUND_STEP (SOUND_ALIEN_LOW_FREQ) },
+  { SEQ_END, 0, 0, 0 }
+};
+
+// Mystery ships go woo woo woo
+const SoundOp mysteryFlybyScript[] PROGMEM = {
+  { SEQ_TONE, SOUND_MYSTERY_FLY_COUNTDOWN, SOUND_STEP (SOUND_MYSTERY_FLY_LOW_FREQ), 0 },
+  { SEQ_SWEEP, SOUND_MYSTERY_FLY_COUNTDOWN, SOUND_STEP (SOUND_MYSTERY_FLY_FREQ_STEP), SOUND_STEP (SOUND_MYSTERY_FLY_HIGH_FREQ) },
+  { SEQ_SWEEP, SOUND_MYSTERY_FLY_COUNTDOWN, -SOUND_STEP (SOUND_MYSTERY_FLY_FREQ_STEP), SOUND_STEP (SOUND_MYSTERY_FLY_LOW_FREQ) },
+  { SEQ_JUMP, 0, -2, 0 }
+};
+
+// And then go wawawa when shot
+const SoundOp mysteryKilledScript[] PROGMEM = {
+  { SEQ_TONE, SOUND_MYSTERY_KILL_COUNTDOWN, SOUND_STEP (SOUND_MYSTERY_KILL_LOW_FREQ), 0 },
+  { SEQ_SWEEP, SOUND_MYSTERY_KILL_COUNTDOWN, SOUND_STEP (SOUND_MYSTERY_KILL_FREQ_STEP), SOUND_STEP (SOUND_MYSTERY_KILL_HIGH_FREQ) },
+  { SEQ_SWEEP, SOUND_MYSTERY_KILL_COUNTDOWN, -SOUND_STEP (SOUND_MYSTERY_KILL_FREQ_STEP), SOUND_STEP (SOUND_MYSTERY_KILL_LOW_FREQ) },
+  { SEQ_JUMP, 0, -2, 0 }
+};
+
+// White noise is produced by a sequence of random frequencies
+const SoundOp baseExplodeScript[] PROGMEM = {
+  { SEQ_NOISE, SOUND_EXPLODE_COUNTDOWN, SOUND_STEP (SOUND_EXPLODE_LOW_FREQ), SOUND_STEP (SOUND_EXPLODE_HIGH_FREQ - SOUND_EXPLODE_LOW_FREQ) }
+};
+
+// The tones must stay under half the sample rate (see sound.h)
+static_assert (SOUND_LASER_FREQ + SOUND_LASER_HISS < SOUND_SAMPLE_RATE / 2, "The laser is too high for the sample rate");
+static_assert (SOUND_MYSTERY_FLY_HIGH_FREQ < SOUND_SAMPLE_RATE / 2, "The mystery ship is too high for the sample rate");
+static_assert (SOUND_EXPLODE_HIGH_FREQ < SOUND_SAMPLE_RATE / 2, "The explosion is too high for the sample rate");
+
+/*
+ * The sound effects, in the same order as the sound priorities (starting
+ * with SOUND_ALIEN_MARCH)
+ */
+const SoundEffect effects[] PROGMEM = {
+  { VOICE_MARCH, marchScript, waveSaw },
+  { VOICE_EFFECT, laserScript, waveSquare },
+  { VOICE_EFFECT, alienKilledScript, waveSquare },
+  { VOICE_MYSTERY, mysteryFlybyScript, waveSquare },
+  { VOICE_MYSTERY, mysteryKilledScript, waveSquare },
+  { VOICE_EFFECT, baseExplodeScript, waveSquare }
+};
+
+/*
+ * Set up the sound output (the timers, see AvrAudio)
+ */
+void Sound::init () {
+  Audio::init (SOUND_SAMPLE_RATE);
+  tickCountdown = SOUND_TICK;
+}
 
 /*
  * The classic alien march sound... well as faithfully reproduced as possible
  * on a tinny piezo buzzer.
  */
-int Sound::alienMarch (int countdown) {
-  if (currentSound <= SOUND_ALIEN_MARCH) {
-    switch (currentFrequency) {
-      case SOUND_MARCH1_FREQ:
-        currentFrequency = SOUND_MARCH2_FREQ;
-        break;
-      case SOUND_MARCH2_FREQ:
-        currentFrequency = SOUND_MARCH3_FREQ;
-        break;
-      case SOUND_MARCH3_FREQ:
-        currentFrequency = SOUND_MARCH4_FREQ;
-        break;
-      default:
-        currentFrequency = SOUND_MARCH1_FREQ;
-    }
-    tone (SOUND_PIN, currentFrequency, SOUND_MARCH_COUNTDOWN);
-    return (SOUND_MARCH_COUNTDOWN);
-  }
-  return (countdown);
+void Sound::alienMarch () {
+  start (SOUND_ALIEN_MARCH, marchNote * 2);
+  marchNote = (marchNote + 1) & 3;
 }
 
 /*
  * The sound of the laser - pew pew
  */
-int Sound::laserFire (int countdown) {
-  if (currentSound <= SOUND_LASER_FIRE) {
-    tone (SOUND_PIN, SOUND_LASER_FREQ);
-    currentSound = SOUND_LASER_FIRE;
-    return (SOUND_LASER_COUNTDOWN);
-  }
-  return (countdown);
+void Sound::laserFire () {
+  start (SOUND_LASER_FIRE, 0);
 }
 
 /*
  * Starts a decending tone
  */
-int Sound::alienKilled (int countdown) {
-  if (currentSound <= SOUND_ALIEN_KILLED) {
-    tone (SOUND_PIN, SOUND_ALIEN_HIGH_FREQ);
-    currentSound = SOUND_ALIEN_KILLED;
-    currentFrequency = SOUND_ALIEN_HIGH_FREQ;
-    return (SOUND_ALIEN_COUNTDOWN);
-  }
-  return (countdown);
+void Sound::alienKilled () {
+  start (SOUND_ALIEN_KILLED, 0);
 }
 
 /*
  * The mystery ship creates an undulating tone
  */
-int Sound::mysteryFlyby (int countdown) {
-  if (currentSound <= SOUND_MYSTERY_FLYBY) {
-    tone (SOUND_PIN, SOUND_MYSTERY_FLY_LOW_FREQ);
-    currentSound = SOUND_MYSTERY_FLYBY;
-    currentFrequency = SOUND_MYSTERY_FLY_LOW_FREQ;
-    ascending = true;
-    return (SOUND_MYSTERY_FLY_COUNTDOWN);
-  }
-  return (countdown);
+void Sound::mysteryFlyby () {
+  start (SOUND_MYSTERY_FLYBY, 0);
 }
 
 /*
  * Which speeds up and get lower when they're shot
  */
-int Sound::mysteryKilled (int countdown) {
-  if (currentSound <= SOUND_MYSTERY_KILLED) {
-    tone (SOUND_PIN, SOUND_MYSTERY_KILL_LOW_FREQ);
-    currentSound = SOUND_MYSTERY_KILLED;
-    currentFrequency = SOUND_MYSTERY_KILL_LOW_FREQ;
-    ascending = true;
-    return (SOUND_MYSTERY_KILL_COUNTDOWN);
-  }
-  return (countdown);
+void Sound::mysteryKilled () {
+  start (SOUND_MYSTERY_KILLED, 0);
 }
 
 /*
  * Start the explosion noise
  */
-int Sound::baseExplode () {
-  tone (SOUND_PIN, random (SOUND_EXPLODE_LOW_FREQ, SOUND_EXPLODE_HIGH_FREQ));
-  currentSound = SOUND_BASE_EXPLODE;
-  return (random (1, 5));
+void Sound::baseExplode () {
+  start (SOUND_BASE_EXPLODE, 0);
+}
+
+/*
+ * Start a sound on its voice, unless the voice is busy with a more important one
+ * The first instruction of the script is run straight away.
+ */
+void Sound::start (uint8_t sound, uint8_t firstOp) {
+  if (muted) return;
+  const SoundEffect *effect = &effects[sound - 1];
+  noInterrupts ();
+  Voice &v = voice[pgm_read_byte (&effect->voice)];
+  if (v.sound <= sound) {
+    v.sound = sound;
+    v.wave = (const uint8_t *)pgm_read_ptr (&effect->wave);
+    v.op = (const SoundOp *)pgm_read_ptr (&effect->script) + firstOp;
+    update (v);
+#ifdef SOUND_TIMELINE
+    log (&v - voice, false);
+#endif
+    // Make sure the interrupt is running
+    Audio::sampleInterrupt (true);
+  }
+  interrupts ();
+}
+
+/*
+ * Stop a voice if it's playing either of the sounds given
+ */
+void Sound::stop (uint8_t v, uint8_t sound1, uint8_t sound2) {
+  noInterrupts ();
+  if (voice[v].sound == sound1 || voice[v].sound == sound2) {
+    voice[v].sound = SOUND_NONE;
+#ifdef SOUND_TIMELINE
+    log (v, false);
+#endif
+  }
+  interrupts ();
 }
 
 /*
  * Stop all sounds
  */
 void Sound::soundStop () {
-  currentSound = SOUND_NONE;
-  noTone(SOUND_PIN);
-}
-
-/*
- * This function is called periodically, according to the required delay
- * It alters the sound if necessary.
- */
-int Sound::countdownComplete () {
-  switch (currentSound) {
-    case SOUND_LASER_FIRE:
-      // The laser sound is quite high frequency with a small random element.
-      // This gives the sound a sort of hiss, like the original game.
-      tone (SOUND_PIN, SOUND_LASER_FREQ + random (200));
-      return (SOUND_LASER_COUNTDOWN);
-    case SOUND_ALIEN_KILLED:
-      // When aliens are shot they just produce a decending tone
-      currentFrequency -= SOUND_ALIEN_FREQ_STEP;
-      // Which stops when it drops below the threshold
-      if (currentFrequency <= SOUND_ALIEN_LOW_FREQ) {
-        noTone (SOUND_PIN);
-        currentSound = SOUND_NONE;
-      } else {
-        tone (SOUND_PIN, currentFrequency);
-        return (SOUND_ALIEN_COUNTDOWN);
-      }
-      break;
-    case SOUND_MYSTERY_FLYBY:
-      // Mystery ships go woo woo woo
-      if (ascending) {
-        currentFrequency += SOUND_MYSTERY_FLY_FREQ_STEP;
-        if (currentFrequency >= SOUND_MYSTERY_FLY_HIGH_FREQ) {
-          ascending = false;
-        }
-      } else {
-        currentFrequency -= SOUND_MYSTERY_FLY_FREQ_STEP;
-        if (currentFrequency <= SOUND_MYSTERY_FLY_LOW_FREQ) {
-          ascending = true;
-        }
-      }
-      tone (SOUND_PIN, currentFrequency);
-      return (SOUND_MYSTERY_FLY_COUNTDOWN);
-    case SOUND_MYSTERY_KILLED:
-      // And then go wawawa when shot
-      if (ascending) {
-        currentFrequency += SOUND_MYSTERY_KILL_FREQ_STEP;
-        if (currentFrequency >= SOUND_MYSTERY_KILL_HIGH_FREQ) {
-          ascending = false;
-        }
-      } else {
-        currentFrequency -= SOUND_MYSTERY_KILL_FREQ_STEP;
-        if (currentFrequency <= SOUND_MYSTERY_KILL_LOW_FREQ) {
-          ascending = true;
-        }
-      }
-      tone (SOUND_PIN, currentFrequency);
-      return (SOUND_MYSTERY_KILL_COUNTDOWN);
-    case SOUND_BASE_EXPLODE:
-      // White noise is produced by a sequence of random frequencies over random short durations
-      tone (SOUND_PIN, random (SOUND_EXPLODE_LOW_FREQ, SOUND_EXPLODE_HIGH_FREQ), random (2, 6));
-      return (SOUND_EXPLODE_COUNTDOWN);
-    case SOUND_ALIEN_MARCH:
-      // The march sound is started by its start function and simply stopped here
-      currentSound = SOUND_NONE;
+  noInterrupts ();
+  for (uint8_t i = 0; i < SOUND_VOICES; i ++) {
+    if (voice[i].sound) {
+      voice[i].sound = SOUND_NONE;
+#ifdef SOUND_TIMELINE
+      log (i, false);
+#endif
+    }
   }
-  // Default action. Turn off sound.
-  noTone (SOUND_PIN);
-  return (SOUND_MAX_COUNTDOWN);
+  interrupts ();
 }
 
 /*
- * Identify the current sound
+ * Mute (or unmute) all sounds
+ */
+void Sound::mute (boolean on) {
+  if (on) soundStop ();
+  muted = on;
+}
+
+/*
+ * Identify the current sound (the most important one, if there are several)
  */
 uint8_t Sound::soundPlaying () {
-  return (currentSound);
+  uint8_t playing = SOUND_NONE;
+  for (uint8_t i = 0; i < SOUND_VOICES; i ++) {
+    playing = max (playing, voice[i].sound);
+  }
+  return (playing);
 }
 
 /*
@@ -200,10 +250,7 @@ uint8_t Sound::soundPlaying () {
  * or goes off the screen.
  */
 void Sound::laserStop () {
-  if (currentSound == SOUND_LASER_FIRE) {
-    currentSound = SOUND_NONE;
-    noTone (SOUND_PIN);
-  }
+  stop (VOICE_EFFECT, SOUND_LASER_FIRE, SOUND_LASER_FIRE);
 }
 
 /*
@@ -211,8 +258,134 @@ void Sound::laserStop () {
  * stop. It's really irritating when you forget to.
  */
 void Sound::mysteryStop () {
-  if (currentSound == SOUND_MYSTERY_FLYBY || currentSound == SOUND_MYSTERY_KILLED) {
-    currentSound = SOUND_NONE;
-    noTone (SOUND_PIN);
+  stop (VOICE_MYSTERY, SOUND_MYSTERY_FLYBY, SOUND_MYSTERY_KILLED);
+}
+
+/*
+ * Run the voice's script until an instruction says to wait
+ * Called when the voice's countdown runs out
+ */
+void Sound::update (Voice &v) {
+  TRACE_SCOPE_SIM (TRACE_SOUND_UPDATE);
+  while (true) {
+    uint8_t code = pgm_read_byte (&v.op->code);
+    int16_t a = pgm_read_word (&v.op->a);
+    uint16_t b = pgm_read_word (&v.op->b);
+    v.countdown = pgm_read_byte (&v.op->time);
+    switch (code) {
+      case SEQ_TONE:
+        v.step = a;
+        v.op ++;
+        break;
+      case SEQ_SWEEP:
+        v.step += a;
+        // Move on when the limit is reached (sweeping in either direction)
+        if (a > 0 ? v.step >= b : v.step <= b) {
+          v.op ++;
+        }
+        break;
+      case SEQ_NOISE:
+        v.step = a + soundRandom.below (b);
+        break;
+      case SEQ_JUMP:
+        v.op += a;
+        continue;
+      default:
+        // End of the sound
+        v.sound = SOUND_NONE;
+#ifdef SOUND_TIMELINE
+        log (&v - voice, false);
+#endif
+        return;
+    }
+    if (v.countdown) return;
   }
 }
+
+/*
+ * Work out the next sample
+ * Every millisecond, the sounds are updated too.
+ */
+void Sound::interrupt () {
+  uint8_t level = 0;
+  boolean playing = false;
+  boolean tick = (-- tickCountdown == 0);
+  if (tick) tickCountdown = SOUND_TICK;
+  for (uint8_t i = 0; i < SOUND_VOICES; i ++) {
+    Voice &v = voice[i];
+    if (v.sound) {
+      if (tick && -- v.countdown == 0) {
+        update (v);
+#if defined (SOUND_TIMELINE) && defined (SOUND_TIMELINE_STEPS)
+        // Log the step the script has moved on to (start () logs the first one, with the sound)
+        if (v.sound) log (i, true);
+#endif
+      }
+      v.phase += v.step;
+      level += pgm_read_byte (v.wave + (v.phase >> (16 - SOUND_WAVE_BITS)));
+      playing = true;
+    }
+  }
+  Audio::output (level);
+  // Nothing to play, so stop interrupting
+  if (!playing) Audio::sampleInterrupt (false);
+}
+
+#ifdef SOUND_TIMELINE
+/*
+ * Add the state of a voice to the timeline
+ */
+void Sound::log (uint8_t v, boolean change) {
+  uint8_t next = (timelineHead + 1) % SOUND_TIMELINE_SIZE;
+  if (next == timelineTail) {
+    // Full - the main loop isn't keeping up
+    if (timelineLost < 255) timelineLost ++;
+    return;
+  }
+  SoundEvent &event = timeline[timelineHead];
+  event.time = Clock::millis ();
+  event.voice = v;
+  event.sound = voice[v].sound;
+  event.step = voice[v].step;
+  event.change = change;
+  timelineHead = next;
+}
+
+/*
+ * Print the logged events, one per line:
+ * SOUND <millis> <voice> <sound> <frequency>
+ * STEP <millis> <voice> <sound> <frequency>
+ * SOUND LOST <count>
+ * (sound 0 means the voice stopped, STEP is a change of frequency)
+ */
+void Sound::timelineReport () {
+  while (timelineTail != timelineHead) {
+    noInterrupts ();
+    SoundEvent event = timeline[timelineTail];
+    uint8_t lost = timelineLost;
+    timelineLost = 0;
+    interrupts ();
+    timelineTail = (timelineTail + 1) % SOUND_TIMELINE_SIZE;
+    if (lost) {
+      Serial.print (F("SOUND LOST "));
+      Serial.println (lost);
+    }
+    Serial.print (event.change ? F("STEP ") : F("SOUND "));
+    Serial.print (event.time);
+    Serial.print (' ');
+    Serial.print (event.voice);
+    Serial.print (' ');
+    Serial.print (event.sound);
+    Serial.print (' ');
+    Serial.println (((uint32_t)event.step * SOUND_SAMPLE_RATE) >> 16);
+  }
+}
+#endif
+
+/*
+ * The sample rate timer
+ */
+HAL_ISR (HAL_AUDIO_VECT) {
+  TRACE_SCOPE_SIM (TRACE_SOUND);
+  sounds.interrupt ();
+}
@@ -11,7 +11,25 @@
 #ifndef sound_h
 #define sound_h
 #include <Arduino.h>
-#include "hardware.h"
+#include "hal.h"
+#include "rng.h"
+
+/*
+ * Uncomment to log every sound starting and stopping over the serial port,
+ * with the time in milliseconds. Capture the log from a demo, or a replayed
+ * game, and check it against an earlier capture with tools/sound_timeline.py
+ * to make sure changes to the loop haven't moved the sounds about.
+ * bench/sound_timeline.log is the demo on the host, to check against.
+ * The demo is normally silent, but plays its sounds when this is defined.
+ * SOUND_TIMELINE_STEPS logs every change of frequency within a sound as
+ * well (the sweeps, the noise and so on). That's up to 1000 events a second
+ * for each voice, which is far more than 9600 baud can carry, so comment it
+ * out for a capture from the Arduino - it's the starts and stops that get
+ * compared then.
+ */
+//#define SOUND_TIMELINE
+#define SOUND_TIMELINE_STEPS
+#define SOUND_TIMELINE_SIZE 16  // Events that can be waiting to be printed
 
 // Sound priorites
 #define SOUND_NONE 0
@@ -22,6 +40,31 @@
 #define SOUND_MYSTERY_KILLED 5
 #define SOUND_BASE_EXPLODE 6
 
+// The voices (sounds on the same voice replace each other, according to priority)
+#define VOICE_MARCH 0       // The alien march
+#define VOICE_EFFECT 1      // Laser, alien killed and base explosion
+#define VOICE_MYSTERY 2     // Mystery ship
+#define SOUND_VOICES 3
+
+/*
+ * Synthesis
+ * 10kHz keeps the interrupt from taking too much of the game's time,
+ * and it's enough for the tones, which all stay under half of it (the
+ * highest are the laser, up to 3.6kHz, and the top of the mystery ship's
+ * sweep, at 4kHz). Up there a square wave only gets two or three samples a
+ * cycle, and its harmonics fold back down as odd, lower tones, so the laser
+ * and the mystery ship come out harsher than a true square wave. That's
+ * accepted - through a piezo, it mostly sounds like the hiss and warble it's
+ * meant to be. Raising the rate would clean them up, but costs the interrupt
+ * time in proportion.
+ */
+#define SOUND_SAMPLE_RATE 10000 // Samples per second
+#define SOUND_TICK (SOUND_SAMPLE_RATE / 1000) // Samples per millisecond (sounds are updated every millisecond)
+#define SOUND_WAVE_BITS 5   // Wave tables have 2 ^ SOUND_WAVE_BITS samples
+#define SOUND_LEVEL 85      // The loudest sample of a single voice (three voices must fit into 255)
+// Convert a frequency to the amount the wave table position moves each sample
+#define SOUND_STEP(freq) ((uint16_t)(((uint32_t)(freq) * 65536UL) / SOUND_SAMPLE_RATE))
+
 // The alien march sounds
 // No, these are not the real frequencies from the game, which were around 200Hz
 // But they sounded pants on a piezo.
@@ -33,6 +76,7 @@
 
 // Laser frequency
 #define SOUND_LASER_FREQ 3400
+#define SOUND_LASER_HISS 200
 #define SOUND_LASER_COUNTDOWN 1
 
 // Alien death
@@ -61,31 +105,104 @@
 #define SOUND_EXPLODE_HIGH_FREQ 3000
 #define SOUND_EXPLODE_COUNTDOWN 1
 
-// Countdown limit
-#define SOUND_MAX_COUNTDOWN 32767
+/*
+ * Sound effect scripts
+ * Each sound effect is a short list of instructions in progmem, run by the
+ * sound interrupt. An instruction either changes the frequency and waits for
+ * the given number of milliseconds, or moves on to another instruction.
+ * Frequencies are given as steps (see SOUND_STEP).
+ */
+#define SEQ_END 0           // Stop the sound
+#define SEQ_TONE 1          // Set the step to a, then wait
+#define SEQ_SWEEP 2         // Add a to the step and wait, until the step reaches b (then move on)
+#define SEQ_NOISE 3         // Set the step to a random value from a to a + b - 1 and wait (forever)
+#define SEQ_JUMP 4          // Move a instructions forward (or back if a is negative) without waiting
+
+struct SoundOp {
+  uint8_t code;             // What to do (SEQ_...)
+  uint8_t time;             // Milliseconds to wait afterwards
+  int16_t a;
+  uint16_t b;
+};
+
+/*
+ * Sound effects
+ * The sound effect table (in sound.cpp) holds one of these for each sound,
+ * in order of priority.
+ */
+struct SoundEffect {
+  uint8_t voice;            // The voice it plays on
+  const SoundOp *script;    // The script (in progmem)
+  const uint8_t *wave;      // The wave table (in progmem)
+};
+
+/*
+ * A voice is a single tone, read from a wave table at a given speed
+ */
+struct Voice {
+  uint16_t phase;           // Position in the wave table (the top SOUND_WAVE_BITS bits are used)
+  uint16_t step;            // How far the position moves each sample (ie. the frequency)
+  const uint8_t *wave;      // The wave table (in progmem)
+  const SoundOp *op;        // The next instruction of the sound effect script (in progmem)
+  uint8_t sound;            // The sound being played (SOUND_NONE if silent)
+  uint8_t countdown;        // Milliseconds until the next instruction
+};
+
+#ifdef SOUND_TIMELINE
+/*
+ * A sound starting or stopping, or changing frequency
+ */
+struct SoundEvent {
+  uint16_t time;            // millis (just the bottom 16 bits, the log reader unwraps them)
+  uint8_t voice;
+  uint8_t sound;            // The sound started (SOUND_NONE if the voice stopped)
+  uint16_t step;            // The step it started at (or changed to)
+  boolean change;           // The script changed the step, rather than the sound starting or stopping
+};
+#endif
 
 class Sound {
   public:
-    int alienMarch (int countdown);
-    int laserFire (int countdown);
-    int alienKilled (int countdown);
-    int mysteryFlyby (int countdown);
-    int mysteryKilled (int countdown);
-    int baseExplode ();
-    int countdownComplete ();
+    void init ();
+    void alienMarch ();
+    void laserFire ();
+    void alienKilled ();
+    void mysteryFlyby ();
+    void mysteryKilled ();
+    void baseExplode ();
     void soundStop ();
     void laserStop ();
     void mysteryStop ();
     uint8_t soundPlaying ();
+    void mute (boolean on);     // Stop all sounds, and ignore any more until unmuted
+    void interrupt ();          // Produce the next sample (called by the timer interrupt)
+#ifdef SOUND_TIMELINE
+    void timelineReport ();     // Print any logged sound events
+#endif
 
   private:
-    uint8_t currentSound;
-    uint16_t currentFrequency;
-    boolean ascending;
+    void start (uint8_t sound, uint8_t firstOp);
+    void stop (uint8_t v, uint8_t sound1, uint8_t sound2);
+    void update (Voice &v);
+    Voice voice[SOUND_VOICES];
+    uint8_t tickCountdown;      // Samples until the next millisecond
+    uint8_t marchNote;          // The next note of the march
+    boolean muted;
+#ifdef SOUND_TIMELINE
+    void log (uint8_t v, boolean change);   // Log the current state of a voice (interrupts must be off)
+    SoundEvent timeline[SOUND_TIMELINE_SIZE];
+    volatile uint8_t timelineHead;  // Where the next event goes
+    volatile uint8_t timelineTail;  // The next event to print
+    volatile uint8_t timelineLost;  // Events dropped because the log was full
+#endif
 };
 
+#ifdef SOUND_TIMELINE
+#define SOUND_TIMELINE_REPORT() sounds.timelineReport ()
+#else
+#define SOUND_TIMELINE_REPORT()
+#endif
 
-
-
+extern Sound sounds;
 
 #endif
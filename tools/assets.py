@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+################################################################################
+#                                                                              #
+# Author: Nicholaus D. Cranch (N.I.X Consulting)                               #
+# e-mail: info@nix-consulting.co.uk                                            #
+#                                                                              #
+# The following code may be used freely for personal, demonstration and        #
+# teaching purposes only. Permission will be required for commercial use, as   #
+# stipulated by GNU GPLv3.                                                     #
+#                                                                              #
+################################################################################
+#
+# Builds bitmap_data.h from the pictures in assets/bitmaps.txt. It works out
+# the BM_ offsets, so there's no more adding up widths by hand, and writes a
+# table of the width and height of each bitmap.
+#
+# Usage:
+#   assets.py [assets/bitmaps.txt] [-o bitmap_data.h] [--check]
+#
+# Each bitmap in the source starts with a line holding its name (and a
+# comment, if you like), followed by up to 5 rows of pixels, # for on and .
+# for off. Lines starting with // are ignored.
+#
+# Every layout is written, one after the other, and bitmaps.h picks one:
+#   packed - repeated columns are squashed into runs (see BitmapReader in
+#            SSD1306.h). The default, as it saves a third of the title.
+#   plain  - every column in full.
+#
+# It prints what each bitmap costs to draw in the packed layout: reads is
+# the bytes read from progmem per blit, repeats is the columns that come out
+# of a run instead. A read column costs the same as a plain one, plus a bit
+# test. A repeated column skips the progmem read, so it's a little cheaper.
+#
+# --check doesn't write anything, it fails if bitmap_data.h is out of date.
+#
+import argparse
+import os
+import re
+import sys
+
+HEIGHT = 5              # The most rows a bitmap can have (see drawBitmap)
+END = 0x80
+RUN = 0x40
+COLUMN = 0x1F
+MAX_RUN = COLUMN + 1    # The most repeats a single run byte can hold
+MAX_OFFSET = 2047       # Display list items only have room for 11 bits (see SSD1306.h)
+PER_LINE = 11           # Bytes per line for the long bitmaps
+LAYOUTS = ['packed', 'plain']
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+BANNER = '\n'.join(open(os.path.join(ROOT, 'bitmaps.h')).read().splitlines()[:10]) + '\n'
+
+
+class Bitmap:
+    def __init__(self, name, comment, line):
+        self.name = name
+        self.comment = comment
+        self.line = line
+        self.rows = []
+        self.columns = []
+        self.height = 0
+
+
+def read(path):
+    bitmaps = []
+    for n, text in enumerate(open(path), 1):
+        text = text.strip()
+        if not text or text.startswith('//'):
+            continue
+        if text.startswith('BM_'):
+            name, _, comment = text.partition(' ')
+            bitmaps.append(Bitmap(name, comment.strip(), n))
+        elif re.match(r'^[#.]+$', text) and bitmaps:
+            bitmaps[-1].rows.append(text)
+        else:
+            sys.exit('%s:%d: not a bitmap name or a row of pixels' % (path, n))
+    names = set()
+    for b in bitmaps:
+        where = '%s:%d: %s' % (path, b.line, b.name)
+        if b.name in names:
+            sys.exit(where + ' is defined twice')
+        names.add(b.name)
+        if not b.rows or len(b.rows) > HEIGHT:
+            sys.exit(where + ' needs 1 to %d rows of pixels' % HEIGHT)
+        if any(len(r) != len(b.rows[0]) for r in b.rows):
+            sys.exit(where + ' has rows of different widths')
+        b.height = len(b.rows)
+        b.columns = [sum(1 << y for y, r in enumerate(b.rows) if r[x] == '#') for x in range(len(b.rows[0]))]
+    return bitmaps
+
+
+def encode(columns, layout):
+    """Turns columns into bytes for the given layout"""
+    data = []
+    i = 0
+    while i < len(columns):
+        data.append(columns[i])
+        repeats = 0
+        if layout == 'packed':
+            while i + 1 + repeats < len(columns) and columns[i + 1 + repeats] == columns[i] and repeats < MAX_RUN:
+                repeats += 1
+        # A run byte only saves anything if it replaces two columns or more
+        if repeats >= 2:
+            data.append(RUN | (repeats - 1))
+            i += repeats
+        i += 1
+    data[-1] |= END
+    return data
+
+
+def generate(bitmaps):
+    out = [BANNER, '/*\n * Generated by tools/assets.py from assets/bitmaps.txt - edit those, not this\n */\n']
+    out.append('#ifndef bitmap_data_h\n#define bitmap_data_h\n\n')
+    for layout in LAYOUTS:
+        if layout == LAYOUTS[0]:
+            # The first layout is the one used unless another is asked for
+            out.append('#if ' + ' && '.join('!defined (BITMAPS_%s)' % l.upper() for l in LAYOUTS[1:]) + '\n')
+        else:
+            out.append('#elif defined (BITMAPS_%s)\n' % layout.upper())
+        offset = 0
+        defines = []
+        lines = []
+        for b in bitmaps:
+            data = encode(b.columns, layout)
+            defines.append('#define %s %d' % (b.name, offset))
+            offset += len(data)
+            values = ['B{:08b}'.format(v) for v in data]
+            rows = [values[i:i + PER_LINE] for i in range(0, len(values), PER_LINE)]
+            if len(rows) > 1 and b.comment:
+                lines.append('  // ' + b.comment)
+            for n, row in enumerate(rows):
+                line = '  ' + ', '.join(row) + ','
+                if len(rows) == 1 and b.comment:
+                    line += ' // ' + b.comment
+                lines.append(line)
+        if offset - 1 > MAX_OFFSET:
+            sys.exit('the %s bitmaps are too big for a display list item (see SSD1306.h)' % layout)
+        last = lines[-1].rfind(',')
+        lines[-1] = lines[-1][:last] + lines[-1][last + 1:]
+        out.append('\n'.join(defines) + '\n')
+        out.append('#define BM_SIZE %d\n\n' % offset)
+        out.append('const uint8_t bitmaps[] PROGMEM = {\n' + '\n'.join(lines) + '\n};\n\n')
+    out.append('#endif\n\n')
+    out.append('#define BM_COUNT %d\n\n' % len(bitmaps))
+    out.append('/*\n * The size of each bitmap, in the same order as the bitmaps\n */\n')
+    out.append('const BitmapInfo bitmapInfo[BM_COUNT] PROGMEM = {\n')
+    out.append(',\n'.join('  { %s, %d, %d }' % (b.name, len(b.columns), b.height) for b in bitmaps))
+    out.append('\n};\n\n#endif\n')
+    return ''.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Build bitmap_data.h from the bitmap sources')
+    parser.add_argument('source', nargs='?', default=os.path.join(ROOT, 'assets', 'bitmaps.txt'))
+    parser.add_argument('-o', '--output', default=os.path.join(ROOT, 'bitmap_data.h'))
+    parser.add_argument('--check', action='store_true', help='fail if the output is out of date')
+    args = parser.parse_args()
+
+    bitmaps = read(args.source)
+    text = generate(bitmaps)
+    if args.check:
+        if not os.path.exists(args.output) or open(args.output).read() != text:
+            sys.exit('%s is out of date, run tools/assets.py' % args.output)
+        return
+
+    print('%-16s %7s %5s %6s %5s' % ('bitmap', 'columns', 'reads', 'repeats', 'saved'))
+    plain = packed = 0
+    for b in bitmaps:
+        data = encode(b.columns, 'packed')
+        plain += len(b.columns)
+        packed += len(data)
+        if len(data) < len(b.columns):
+            runs = sum(1 for v in data if v & RUN)
+            print('%-16s %7d %5d %6d %5d' % (b.name, len(b.columns), len(data), len(b.columns) - len(data) + runs, len(b.columns) - len(data)))
+    print('%d bitmaps, %d bytes plain, %d bytes packed (%d saved)' % (len(bitmaps), plain, packed, plain - packed))
+    open(args.output, 'w').write(text)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,231 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * Runs the firmware under simavr, for counting cycles without an Arduino
+ *
+ * The simulator is cycle accurate, so unlike the host build (see hal.h) the
+ * times include everything an ATmega328P really has to do - 8 bit sums, no
+ * divider, reading the bitmaps out of progmem and the interrupts. It plays
+ * the part of the rest of the hardware:
+ * - The display is a device at OLED_ADDR on the TWI bus that takes whatever
+ *   it's sent (and counts it).
+ * - The buttons are pressed by a script (or a built in one that starts a
+ *   game and plays it badly).
+ * - Every write to GPIOR0 is logged with the cycle it happened on. Build the
+ *   sketch with TRACE_SIM defined in trace.h and that's when the traced
+ *   functions start and finish.
+ *
+ * Build it (simavr and libelf need to be installed), from the sketch folder:
+ *   make -C tools avr_sim
+ * Build the sketch for the Uno (Sketch / Export compiled binary in the IDE
+ * leaves the .elf in the build folder), then run it and make a flame graph:
+ *   make -C tools trace ELF=/path/to/Invaders.ino.elf
+ * or by hand:
+ *   build/avr_sim Invaders.ino.elf [-s seconds] [-b buttons.txt] [-o trace.log]
+ *   tools/trace_profile.py trace.log --svg flame.svg
+ *
+ * The button script has a line for each change, the time in milliseconds
+ * and the buttons held from then on (L, R and F, or - for none):
+ *   3000 F
+ *   3100 -
+ *   4000 RF
+ * Anything the sketch prints goes to stdout as usual.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include <simavr/avr_twi.h>
+#include <simavr/avr_ioport.h>
+
+#define CPU_FREQ 16000000
+#define OLED_ADDR 0x3C          // The same as hardware.h
+#define GPIOR0_ADDR 0x3E        // GPIOR0 (I/O 0x1E) in the data space
+
+// The buttons are on port D (see hardware.h)
+#define LEFT_PIN 2
+#define RIGHT_PIN 4
+#define FIRE_PIN 7
+#define BUTTON_LEFT 1
+#define BUTTON_RIGHT 2
+#define BUTTON_FIRE 4
+
+#define SCRIPT_SIZE 1024        // Button changes in a script
+
+struct ButtonChange {
+  unsigned long ms;
+  int buttons;
+};
+
+static struct ButtonChange script[SCRIPT_SIZE];
+static int scriptLength;
+static FILE *traceFile;
+static avr_irq_t *twiIrq;
+static int twiSelected;
+static unsigned long displayBytes;
+static unsigned long traceMarks;
+
+/*
+ * Every write to GPIOR0 goes in the log (and still reaches the register)
+ */
+static void traceWrite (struct avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param) {
+  avr->data[addr] = v;
+  fprintf (traceFile, "TRACE %llu %u\n", (unsigned long long)avr->cycle, v);
+  traceMarks ++;
+}
+
+/*
+ * The display, as far as the TWI bus is concerned - acknowledge its address
+ * and everything written to it
+ */
+static void twiHook (struct avr_irq_t *irq, uint32_t value, void *param) {
+  avr_twi_msg_irq_t v;
+  v.u.v = value;
+  if (v.u.twi.msg & TWI_COND_STOP) {
+    twiSelected = 0;
+  }
+  if (v.u.twi.msg & TWI_COND_START) {
+    twiSelected = (v.u.twi.addr >> 1) == OLED_ADDR;
+    if (twiSelected) {
+      avr_raise_irq (twiIrq + TWI_IRQ_INPUT, avr_twi_irq_msg (TWI_COND_ACK, v.u.twi.addr, 1));
+      displayBytes ++;
+    }
+  }
+  if (twiSelected && (v.u.twi.msg & TWI_COND_WRITE)) {
+    avr_raise_irq (twiIrq + TWI_IRQ_INPUT, avr_twi_irq_msg (TWI_COND_ACK, v.u.twi.addr, 1));
+    displayBytes ++;
+  }
+}
+
+static void attachDisplay (avr_t *avr) {
+  static const char *names[2] = { "8>oled.out", "32<oled.in" };
+  twiIrq = avr_alloc_irq (&avr->irq_pool, 0, 2, names);
+  avr_irq_register_notify (twiIrq + TWI_IRQ_OUTPUT, twiHook, NULL);
+  avr_connect_irq (twiIrq + TWI_IRQ_INPUT, avr_io_getirq (avr, AVR_IOCTL_TWI_GETIRQ (0), TWI_IRQ_INPUT));
+  avr_connect_irq (avr_io_getirq (avr, AVR_IOCTL_TWI_GETIRQ (0), TWI_IRQ_OUTPUT), twiIrq + TWI_IRQ_OUTPUT);
+}
+
+/*
+ * The buttons pull their pins low when pressed
+ */
+static void setButtons (avr_t *avr, int buttons) {
+  avr_raise_irq (avr_io_getirq (avr, AVR_IOCTL_IOPORT_GETIRQ ('D'), LEFT_PIN), !(buttons & BUTTON_LEFT));
+  avr_raise_irq (avr_io_getirq (avr, AVR_IOCTL_IOPORT_GETIRQ ('D'), RIGHT_PIN), !(buttons & BUTTON_RIGHT));
+  avr_raise_irq (avr_io_getirq (avr, AVR_IOCTL_IOPORT_GETIRQ ('D'), FIRE_PIN), !(buttons & BUTTON_FIRE));
+}
+
+/*
+ * The buttons held at a given time
+ * Without a script, fire starts a game after the title, then the base goes
+ * back and forth, firing every so often (which also gets through the high
+ * score entry).
+ */
+static int buttonsAt (unsigned long ms) {
+  if (scriptLength) {
+    int buttons = 0;
+    for (int i = 0; i < scriptLength && script[i].ms <= ms; i ++) {
+      buttons = script[i].buttons;
+    }
+    return (buttons);
+  }
+  if (ms < 3000) return (0);
+  if (ms < 3100) return (BUTTON_FIRE);
+  return (((ms / 700) % 3 == 0 ? BUTTON_FIRE : 0) | ((ms / 3000) % 2 ? BUTTON_LEFT : BUTTON_RIGHT));
+}
+
+static void readScript (const char *path) {
+  FILE *f = fopen (path, "r");
+  char line[80];
+  if (!f) {
+    perror (path);
+    exit (1);
+  }
+  while (fgets (line, sizeof (line), f) && scriptLength < SCRIPT_SIZE) {
+    unsigned long ms;
+    char held[8];
+    if (line[0] == '#' || sscanf (line, "%lu %7s", &ms, held) != 2) continue;
+    script[scriptLength].ms = ms;
+    script[scriptLength].buttons = (strchr (held, 'L') ? BUTTON_LEFT : 0) | (strchr (held, 'R') ? BUTTON_RIGHT : 0) | (strchr (held, 'F') ? BUTTON_FIRE : 0);
+    scriptLength ++;
+  }
+  fclose (f);
+}
+
+int main (int argc, char *argv[]) {
+  unsigned long seconds = 60;
+  const char *tracePath = "trace.log";
+  int opt;
+  while ((opt = getopt (argc, argv, "s:b:o:")) != -1) {
+    switch (opt) {
+      case 's':
+        seconds = strtoul (optarg, NULL, 10);
+        break;
+      case 'b':
+        readScript (optarg);
+        break;
+      case 'o':
+        tracePath = optarg;
+        break;
+      default:
+        fprintf (stderr, "Usage: %s firmware.elf [-s seconds] [-b buttons.txt] [-o trace.log]\n", argv[0]);
+        return (1);
+    }
+  }
+  if (optind >= argc) {
+    fprintf (stderr, "No firmware given\n");
+    return (1);
+  }
+
+  elf_firmware_t firmware;
+  memset (&firmware, 0, sizeof (firmware));
+  if (elf_read_firmware (argv[optind], &firmware) != 0) {
+    fprintf (stderr, "Can't read %s\n", argv[optind]);
+    return (1);
+  }
+  // The Arduino build doesn't say what it's for
+  strcpy (firmware.mmcu, "atmega328p");
+  firmware.frequency = CPU_FREQ;
+  avr_t *avr = avr_make_mcu_by_name (firmware.mmcu);
+  if (!avr) {
+    fprintf (stderr, "simavr doesn't know the %s\n", firmware.mmcu);
+    return (1);
+  }
+  avr_init (avr);
+  avr_load_firmware (avr, &firmware);
+
+  traceFile = fopen (tracePath, "w");
+  if (!traceFile) {
+    perror (tracePath);
+    return (1);
+  }
+  avr_register_io_write (avr, GPIOR0_ADDR, traceWrite, NULL);
+  attachDisplay (avr);
+
+  // Run for the given time, changing the buttons as the milliseconds go by
+  unsigned long limit = seconds * 1000;
+  unsigned long lastMs = (unsigned long)-1;
+  int state = cpu_Running;
+  while (state != cpu_Done && state != cpu_Crashed) {
+    unsigned long ms = avr->cycle / (CPU_FREQ / 1000);
+    if (ms >= limit) break;
+    if (ms != lastMs) {
+      setButtons (avr, buttonsAt (ms));
+      lastMs = ms;
+    }
+    state = avr_run (avr);
+  }
+  fclose (traceFile);
+  fprintf (stderr, "%llu cycles, %lu trace marks, %lu bytes to the display%s\n", (unsigned long long)avr->cycle, traceMarks, displayBytes, state == cpu_Crashed ? " (crashed)" : "");
+  return (state == cpu_Crashed ? 1 : 0);
+}
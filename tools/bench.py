@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+################################################################################
+#                                                                              #
+# Author: Nicholaus D. Cranch (N.I.X Consulting)                               #
+# e-mail: info@nix-consulting.co.uk                                            #
+#                                                                              #
+# The following code may be used freely for personal, demonstration and        #
+# teaching purposes only. Permission will be required for commercial use, as   #
+# stipulated by GNU GPLv3.                                                     #
+#                                                                              #
+################################################################################
+#
+#
+# Checks the microbenchmark results (bench/bench.cpp) against a baseline,
+# and fails if anything has got slower than it allows.
+#
+# Usage:
+#   bench.py results.txt [--baseline build/bench_baseline.txt] [--tolerance percent] [--slack ns] [--update]
+#
+# Use - to read the results from stdin, eg.
+#   build/invaders_bench | tools/bench.py -
+# A benchmark fails if it takes longer than the baseline plus the tolerance
+# (25% by default) plus the slack (1ns by default, so the tiny ones don't
+# fail on noise). The results can hold several runs one after the other, and
+# the fastest of each is used, which steadies them on a busy machine, eg.
+#   for i in 1 2 3; do build/invaders_bench; done | tools/bench.py -
+# Timings depend on the machine, so there's no baseline in the sketch - each
+# machine makes its own. Run it with --update first, before changing
+# anything, to write the results as the baseline (see bench/bench.cpp).
+# Exits with 1 if anything is slower, or has gone missing, or there's no
+# baseline yet.
+#
+import argparse
+import os
+import sys
+
+
+def read_results(f):
+    """Returns a list of (name, ns) in the order they were run (the fastest, if run more than once)"""
+    results = {}
+    for line in f:
+        words = line.split()
+        if len(words) == 3 and words[0] == 'BENCH':
+            ns = float(words[2])
+            results[words[1]] = min(ns, results.get(words[1], ns))
+    return list(results.items())
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Check microbenchmark results against a baseline')
+    parser.add_argument('results', help='benchmark output (- for stdin)')
+    parser.add_argument('--baseline', default='build/bench_baseline.txt', help='the baseline results (default build/bench_baseline.txt)')
+    parser.add_argument('--tolerance', type=float, default=25, help='allowed slow down in percent (default 25)')
+    parser.add_argument('--slack', type=float, default=1, help='allowed slow down in ns on top (default 1)')
+    parser.add_argument('--update', action='store_true', help='save the results as the new baseline')
+    args = parser.parse_args()
+
+    if args.results == '-':
+        results = read_results(sys.stdin)
+    else:
+        with open(args.results) as f:
+            results = read_results(f)
+    if not results:
+        print('No results')
+        sys.exit(1)
+
+    if args.update:
+        if os.path.dirname(args.baseline):
+            os.makedirs(os.path.dirname(args.baseline), exist_ok=True)
+        with open(args.baseline, 'w') as f:
+            for name, ns in results:
+                f.write('BENCH %s %.1f\n' % (name, ns))
+        print('%d results saved to %s' % (len(results), args.baseline))
+        sys.exit(0)
+
+    if not os.path.exists(args.baseline):
+        print('No baseline in %s - run with --update on the unchanged sketch first' % args.baseline)
+        sys.exit(1)
+    with open(args.baseline) as f:
+        baseline = dict(read_results(f))
+    got = dict(results)
+    failed = 0
+    for name, ns in results:
+        if name not in baseline:
+            print('%-24s %10.1fns (new)' % (name, ns))
+            continue
+        base = baseline[name]
+        change = (ns - base) * 100.0 / base if base else 0
+        slower = ns > base * (1 + args.tolerance / 100.0) + args.slack
+        print('%-24s %10.1fns %10.1fns %+6.1f%%%s' % (name, ns, base, change, '  SLOWER' if slower else ''))
+        failed += slower
+    for name in baseline:
+        if name not in got:
+            print('%-24s missing' % name)
+            failed += 1
+    print('%d benchmarks, %d failed' % (len(results), failed))
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+################################################################################
+#                                                                              #
+# Author: Nicholaus D. Cranch (N.I.X Consulting)                               #
+# e-mail: info@nix-consulting.co.uk                                            #
+#                                                                              #
+# The following code may be used freely for personal, demonstration and        #
+# teaching purposes only. Permission will be required for commercial use, as   #
+# stipulated by GNU GPLv3.                                                     #
+#                                                                              #
+################################################################################
+#
+#
+# Builds the game for the PC, with the host backend (see hal.h), and the
+# driver in host/main.cpp that plays it.
+#
+# Usage:
+#   host.py [-D NAME[=VALUE] ...] [-o build/host/invaders] [--run [-- driver options]]
+#   host.py --displays
+#
+# The -D options are passed to the compiler, so any of the compile time
+# switches can be turned on without editing the headers, eg.
+#   host.py -D SCENARIO_BENCH --run
+#   host.py -D CONSOLE -D TRACE_RAM --run -- -c "get;frames;trace;"
+# and so can the display (see hardware.h), eg.
+#   host.py -D OLED_CONTROLLER=SH1106Controller -D OLED_TRANSPORT=OledSpi
+#
+# --displays builds and plays every controller and connection, in buffer and
+# strip mode, with the stand-in display checking every update (see
+# host_panel.h). Exits with 1 if any of them fail.
+#
+# The Arduino IDE adds prototypes for the functions in the .ino before
+# compiling it, so the sketch can call things defined further down. This
+# does the same, well enough for Invaders.ino, into the build folder.
+# It needs g++.
+#
+import argparse
+import glob
+import os
+import re
+import subprocess
+import sys
+
+SKETCH = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+BUILD = os.path.join(SKETCH, 'build', 'host')
+CONTROLLERS = ['SSD1306Controller', 'SSD1309Controller', 'SH1106Controller']
+TRANSPORTS = ['OledI2c', 'OledSpi']
+# A function definition starting a line, eg. "unsigned long gameTick (uint8_t buttons) {"
+DEFINITION = re.compile(r'^([A-Za-z_][\w \t\*&]*?[\s\*&])([A-Za-z_]\w*)\s*\(([^;{}()]*)\)\s*\{', re.M)
+NOT_FUNCTIONS = ('if', 'for', 'while', 'switch', 'return', 'else')
+
+
+def sketch_cpp(ino, out):
+    """Writes the sketch as a .cpp, with prototypes before the first function"""
+    with open(ino) as f:
+        source = f.read()
+    prototypes = []
+    first = None
+    for m in DEFINITION.finditer(source):
+        result, name, args = m.group(1).strip(), m.group(2), m.group(3)
+        if name in NOT_FUNCTIONS or result.split()[0] in NOT_FUNCTIONS:
+            continue
+        if first is None:
+            first = m.start()
+        prototypes.append('%s %s (%s);' % (result, name, args))
+    if first is None:
+        first = len(source)
+    line = source.count('\n', 0, first) + 1
+    with open(out, 'w') as f:
+        f.write('#include <Arduino.h>\n#line 1 "%s"\n' % ino)
+        f.write(source[:first])
+        f.write('\n'.join(prototypes) + '\n')
+        f.write('#line %d "%s"\n' % (line, ino))
+        f.write(source[first:])
+
+
+def build(defines, binary, quiet=False):
+    """Compiles the sketch and the driver - returns True if it worked (quiet only shows errors)"""
+    os.makedirs(BUILD, exist_ok=True)
+    ino = os.path.join(SKETCH, 'Invaders.ino')
+    cpp = os.path.join(BUILD, 'Invaders.cpp')
+    sketch_cpp(os.path.normpath(ino), cpp)
+    sources = sorted(glob.glob(os.path.join(SKETCH, '*.cpp')) + glob.glob(os.path.join(SKETCH, 'host', '*.cpp')))
+    command = ['g++', '-std=gnu++11', '-O2', '-Wall', '-DHAL_HOST',
+               '-I' + os.path.join(SKETCH, 'host'), '-I' + SKETCH]
+    command += ['-D' + d for d in defines]
+    command += [os.path.normpath(s) for s in sources] + [cpp, '-o', binary]
+    if not quiet:
+        return subprocess.call(command) == 0
+    run = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if run.returncode:
+        print(run.stdout)
+    return run.returncode == 0
+
+
+def displays():
+    """Plays every display, in both modes - returns True if they all passed"""
+    passed = True
+    for strip in (False, True):
+        for controller in CONTROLLERS:
+            for transport in TRANSPORTS:
+                defines = ['OLED_CONTROLLER=' + controller, 'OLED_TRANSPORT=' + transport]
+                if strip:
+                    defines.append('SSD1306_STRIP')
+                name = '%s %s %s' % (controller, transport, 'strip' if strip else 'buffer')
+                binary = os.path.join(BUILD, 'invaders_display')
+                if not build(defines, binary, True):
+                    print('%s: FAILED to build' % name)
+                    passed = False
+                    continue
+                run = subprocess.run([binary], stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+                lines = run.stdout.splitlines()
+                panel = [l for l in lines if l.startswith(('PANEL ', 'SPI '))]
+                games = len([l for l in lines if l.startswith('MODE ') and l.split()[2] == '1'])
+                if run.returncode or not panel or not games:
+                    print('%s: FAILED %s' % (name, lines[-1] if lines else 'with no output'))
+                    passed = False
+                else:
+                    print('%s: ok\n  %s' % (name, '\n  '.join(panel)))
+    return passed
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Build the game for the PC')
+    parser.add_argument('-D', dest='defines', action='append', default=[], help='define a compile time switch')
+    parser.add_argument('-o', dest='binary', default=os.path.join(BUILD, 'invaders'), help='where to put the program')
+    parser.add_argument('--run', action='store_true', help='run it afterwards (anything after -- goes to it)')
+    parser.add_argument('--displays', action='store_true', help='play every display and check the screen')
+    args, driver = parser.parse_known_args()
+    if args.displays:
+        sys.exit(0 if displays() else 1)
+    if not build(args.defines, args.binary):
+        sys.exit(1)
+    if args.run:
+        driver = [a for a in driver if a != '--']
+        sys.exit(subprocess.call([args.binary] + driver))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+################################################################################
+#                                                                              #
+# Author: Nicholaus D. Cranch (N.I.X Consulting)                               #
+# e-mail: info@nix-consulting.co.uk                                            #
+#                                                                              #
+# The following code may be used freely for personal, demonstration and        #
+# teaching purposes only. Permission will be required for commercial use, as   #
+# stipulated by GNU GPLv3.                                                     #
+#                                                                              #
+################################################################################
+#
+#
+# Puts the worst case scenario results (see scenario.h) from the host and
+# the Arduino side by side.
+#
+# Usage:
+#   scenario_compare.py host.log arduino.log
+#
+# Get the host's with:
+#   tools/host.py -D SCENARIO_BENCH --run -- -s 1 > host.log
+# and the Arduino's by uncommenting SCENARIO_BENCH in scenario.h, uploading
+# it and saving the serial output from power up (or running the .elf under
+# tools/avr_sim.c).
+#
+# The scenarios are driven by their own random numbers, not the clock, so
+# both should send exactly the same bytes to the display. The CPU times are
+# the PC's and the Arduino's, so they're only shown (with how many times
+# slower the Arduino is). Exits with 1 if the scenarios or bytes differ.
+#
+import argparse
+import sys
+
+
+def read_scenarios(path):
+    """Returns a list of (name, frames, cpu avg, cpu max, bytes avg, bytes max)"""
+    scenarios = []
+    with open(path, errors='replace') as f:
+        for line in f:
+            words = line.split()
+            # (strip mode adds the pages drawn, which aren't compared)
+            if len(words) >= 10 and words[0] == 'SCENARIO' and words[2] == 'FRAMES' and words[4] == 'CPU' and words[7] == 'BYTES':
+                scenarios.append((words[1],) + tuple(int(words[i]) for i in (3, 5, 6, 8, 9)))
+    return scenarios
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare the worst case scenarios on the host and the Arduino')
+    parser.add_argument('host', help='serial output from the host build')
+    parser.add_argument('arduino', help='serial output from the Arduino')
+    args = parser.parse_args()
+
+    host = read_scenarios(args.host)
+    arduino = read_scenarios(args.arduino)
+    failed = not host or [s[0] for s in host] != [s[0] for s in arduino]
+    if failed:
+        print('The scenarios differ: host %s, Arduino %s' % ([s[0] for s in host], [s[0] for s in arduino]))
+    print('%-10s %16s %16s %8s %16s' % ('', 'host cpu us', 'arduino cpu us', 'slower', 'bytes'))
+    for h, a in zip(host, arduino):
+        same = h[1] == a[1] and h[4:] == a[4:]
+        print('%-10s %7d %8d %7d %8d %7.0fx %7d %8d%s' % (h[0], h[2], h[3], a[2], a[3], a[2] / max(h[2], 1),
+                                                         a[4], a[5], '' if same else '  DIFFERENT (host %d %d)' % h[4:]))
+        failed = failed or not same
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main()
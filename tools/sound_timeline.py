@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+################################################################################
+#                                                                              #
+# Author: Nicholaus D. Cranch (N.I.X Consulting)                               #
+# e-mail: info@nix-consulting.co.uk                                            #
+#                                                                              #
+# The following code may be used freely for personal, demonstration and        #
+# teaching purposes only. Permission will be required for commercial use, as   #
+# stipulated by GNU GPLv3.                                                     #
+#                                                                              #
+################################################################################
+#
+# Reads the sound timeline printed over the serial port when SOUND_TIMELINE
+# is defined in sound.h. It can turn the timeline into a WAV file, so you can
+# hear roughly what was played, and compare it against an earlier capture
+# (the golden file) to check nothing has moved.
+#
+# Usage:
+#   sound_timeline.py capture.log [--wav out.wav] [--golden golden.log] [--tolerance ms]
+#
+# Capture the log from the start of the demo, as the demo always plays the
+# same way. The golden file, bench/sound_timeline.log, is 120 seconds of
+# the demo on the host, which runs in virtual time, so printing the log
+# doesn't move anything about. To check against it:
+#   tools/host.py -D SOUND_TIMELINE -o build/host/timeline
+#   build/host/timeline -p 0 -s 120 > capture.log
+#   tools/sound_timeline.py capture.log --golden bench/sound_timeline.log
+# A capture from the Arduino (power up, then save the serial output) works
+# too, but the serial port slows the loop down a little, so it's best
+# compared with another capture from the Arduino.
+# Times are compared relative to the first event, so it doesn't matter
+# exactly when the capture started. Every event must match, frequency and
+# all, so a capture with events missing (or extra ones) fails. A capture
+# without the changes of frequency (SOUND_TIMELINE_STEPS commented out, as
+# it has to be on the Arduino) is compared on the starts and stops alone.
+# Exits with 1 if the timelines don't match.
+#
+import argparse
+import sys
+import wave
+
+SAMPLE_RATE = 10000     # SOUND_SAMPLE_RATE
+LEVEL = 85              # SOUND_LEVEL
+SOUND_NAMES = ['none', 'march', 'laser', 'alien killed', 'mystery flyby', 'mystery killed', 'base explode']
+
+
+def read_timeline(path):
+    """Returns a list of (ms, voice, sound, frequency, step), and the number of lost events
+    step is True for a change of frequency within a sound (a STEP line)"""
+    events = []
+    lost = 0
+    last = None
+    offset = 0
+    with open(path, errors='replace') as f:
+        for line in f:
+            words = line.split()
+            if len(words) < 2 or words[0] not in ('SOUND', 'STEP'):
+                continue
+            if words[1] == 'LOST':
+                lost += int(words[2])
+                continue
+            time, voice, sound, freq = (int(w) for w in words[1:5])
+            # The firmware only sends the bottom 16 bits of millis
+            if last is not None and time + offset < last:
+                offset += 65536
+            last = time + offset
+            events.append((last, voice, sound, freq, words[0] == 'STEP'))
+    if events:
+        start = events[0][0]
+        events = [(t - start, v, s, f, c) for (t, v, s, f, c) in events]
+    return events, lost
+
+
+def render(events, path):
+    """Writes the timeline as an 8 bit WAV, each voice as a square wave
+    Each event plays until the voice's next one, so the sweeps and noise
+    follow the changes of frequency (if they were logged). The phase carries
+    on from one change to the next, as it does in the sound interrupt."""
+    if not events:
+        return
+    length = (events[-1][0] + 100) * SAMPLE_RATE // 1000
+    samples = bytearray(length)
+    phase = {}
+    for i, (time, voice, sound, freq, step) in enumerate(events):
+        end = length
+        for (t, v, s, f, c) in events[i + 1:]:
+            if v == voice:
+                end = t * SAMPLE_RATE // 1000
+                break
+        if sound and freq:
+            p = phase.get(voice, 0.0)
+            for n in range(time * SAMPLE_RATE // 1000, end):
+                if p < 0.5:
+                    samples[n] += LEVEL
+                p = (p + float(freq) / SAMPLE_RATE) % 1.0
+            phase[voice] = p
+    with wave.open(path, 'wb') as w:
+        w.setnchannels(1)
+        w.setsampwidth(1)
+        w.setframerate(SAMPLE_RATE)
+        w.writeframes(bytes(samples))
+
+
+def describe(event):
+    time, voice, sound, freq, step = event
+    name = SOUND_NAMES[sound] if sound < len(SOUND_NAMES) else str(sound)
+    return '%dms voice %d %s %s%dHz' % (time, voice, name if sound else 'stop', 'step to ' if step else '', freq)
+
+
+def compare(events, golden, tolerance):
+    """Returns a list of differences between the two timelines"""
+    problems = []
+    for i, (got, want) in enumerate(zip(events, golden)):
+        if got[1:] != want[1:]:
+            problems.append('event %d: got %s, expected %s' % (i, describe(got), describe(want)))
+            # Once the order differs, everything after it will too
+            return problems
+        if abs(got[0] - want[0]) > tolerance:
+            problems.append('event %d: %s is %+dms out' % (i, describe(got), got[0] - want[0]))
+    if len(events) < len(golden):
+        problems.append('%d events missing, from %s' % (len(golden) - len(events), describe(golden[len(events)])))
+    elif len(events) > len(golden):
+        problems.append('%d extra events, from %s' % (len(events) - len(golden), describe(events[len(golden)])))
+    return problems
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Check and render a sound timeline')
+    parser.add_argument('log', help='serial capture with SOUND and STEP lines')
+    parser.add_argument('--wav', help='render the timeline to this WAV file')
+    parser.add_argument('--golden', help='compare against this earlier capture')
+    parser.add_argument('--tolerance', type=int, default=5, help='allowed timing difference in ms (default 5)')
+    args = parser.parse_args()
+
+    events, lost = read_timeline(args.log)
+    print('%d events over %dms' % (len(events), events[-1][0] if events else 0))
+    if args.wav:
+        render(events, args.wav)
+    failed = False
+    if lost:
+        print('%d events lost (the loop is not printing them fast enough)' % lost)
+        failed = True
+    if args.golden:
+        golden, _ = read_timeline(args.golden)
+        if not any(e[4] for e in events):
+            # No changes of frequency in the capture, so just the starts and stops
+            golden = [e for e in golden if not e[4]]
+        problems = compare(events, golden, args.tolerance)
+        for p in problems:
+            print(p)
+        print('%d events expected, %d problems' % (len(golden), len(problems)))
+        failed = failed or bool(problems) or not golden
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+################################################################################
+#                                                                              #
+# Author: Nicholaus D. Cranch (N.I.X Consulting)                               #
+# e-mail: info@nix-consulting.co.uk                                            #
+#                                                                              #
+# The following code may be used freely for personal, demonstration and        #
+# teaching purposes only. Permission will be required for commercial use, as   #
+# stipulated by GNU GPLv3.                                                     #
+#                                                                              #
+################################################################################
+#
+#
+# Turns a trace of the functions starting and finishing (see trace.h) into
+# times for each function, a flame graph and a timeline.
+#
+# Usage:
+#   trace_profile.py trace.log [--us] [--folded out.folded] [--svg flame.svg] [--chrome trace.json]
+#
+# The trace has a line for each mark, the time it happened and the mark:
+#   TRACE 123456 3      (drawBitmap started)
+#   TRACE 123790 131    (drawBitmap finished - 3 + 128)
+# tools/avr_sim.c writes the time in cycles (TRACE_SIM). The ring buffer
+# (TRACE_RAM) prints it in microseconds, so give --us for those - capture
+# the serial output after sending a 't'. Functions called from traced
+# functions (and interrupts that go off in the middle) are nested inside
+# them, so each function's own time is what's left once those are taken
+# out. The ring buffer only has the last few marks, so calls that started
+# before it are left out.
+# --folded writes the stacks in the format flamegraph.pl and speedscope read.
+# --svg draws the flame graph itself.
+# --chrome writes the calls as a timeline, for chrome://tracing or Perfetto.
+#
+import argparse
+import json
+import sys
+
+CPU_FREQ = 16000000     # Cycles per second
+TRACE_EXIT = 0x80       # TRACE_EXIT
+# The same order as trace.h
+TRACE_NAMES = [None, 'gameLoop', 'update', 'drawBitmap', 'send', 'alienCollision', 'defenceCollision',
+               'baseCollision', 'mysteryCollision', 'soundInterrupt', 'alienStep', 'moveAndCreateBombs',
+               'soundUpdate']
+
+
+def name(mark):
+    return TRACE_NAMES[mark] if mark < len(TRACE_NAMES) else 'trace%d' % mark
+
+
+def read_trace(path):
+    """Returns a list of (cycle, mark)"""
+    marks = []
+    with open(path, errors='replace') as f:
+        for line in f:
+            words = line.split()
+            if len(words) == 3 and words[0] == 'TRACE':
+                marks.append((int(words[1]), int(words[2])))
+    return marks
+
+
+class Stats:
+    def __init__(self):
+        self.calls = 0
+        self.total = 0      # Including anything called
+        self.own = 0        # Just the function itself
+        self.worst = 0
+
+
+def profile(marks):
+    """Returns the stats for each function, the time for each stack, each call (start, time, mark, depth) and the
+    number of unmatched marks"""
+    stats = {}
+    stacks = {}
+    calls = []
+    unmatched = 0
+    stack = []          # [mark, start cycle, cycles in the functions it called]
+    for cycle, mark in marks:
+        if mark & TRACE_EXIT:
+            mark &= ~TRACE_EXIT
+            if not any(frame[0] == mark for frame in stack):
+                unmatched += 1
+                continue
+            # Anything that didn't finish before this one is finished with it
+            while True:
+                frame = stack.pop()
+                taken = cycle - frame[1]
+                s = stats.setdefault(frame[0], Stats())
+                s.calls += 1
+                s.total += taken
+                s.own += taken - frame[2]
+                s.worst = max(s.worst, taken)
+                key = ';'.join([name(f[0]) for f in stack] + [name(frame[0])])
+                stacks[key] = stacks.get(key, 0) + taken - frame[2]
+                calls.append((frame[1], taken, frame[0], len(stack)))
+                if stack:
+                    stack[-1][2] += taken
+                if frame[0] == mark:
+                    break
+                unmatched += 1
+        elif mark:
+            stack.append([mark, cycle, 0])
+    return stats, stacks, calls, unmatched
+
+
+def write_folded(stacks, path):
+    with open(path, 'w') as f:
+        for key in sorted(stacks):
+            f.write('%s %d\n' % (key, stacks[key]))
+
+
+def write_chrome(calls, path, per_us):
+    """Writes the calls as complete events in the Chrome trace format (times in microseconds)"""
+    events = []
+    for start, taken, mark, depth in sorted(calls, key=lambda c: (c[0], -c[1])):
+        events.append({'name': name(mark), 'ph': 'X', 'pid': 1, 'tid': 1,
+                       'ts': start / per_us, 'dur': taken / per_us, 'args': {'depth': depth}})
+    with open(path, 'w') as f:
+        json.dump({'traceEvents': events, 'displayTimeUnit': 'ms'}, f)
+
+
+def write_svg(stacks, path, width=1200, height=18):
+    """Draws the stacks as a flame graph, the callers at the bottom"""
+    # Build a tree of {name: [cycles, children]}
+    root = [0, {}]
+    for key, cycles in stacks.items():
+        node = root
+        node[0] += cycles
+        for part in key.split(';'):
+            node = node[1].setdefault(part, [0, {}])
+            node[0] += cycles
+
+    def depth(node):
+        return 1 + max([depth(child) for child in node[1].values()] or [0])
+
+    levels = depth(root) - 1
+    total = root[0] or 1
+    rects = []
+
+    def draw(node, x, level):
+        for part in sorted(node[1]):
+            child = node[1][part]
+            w = child[0] * width / total
+            y = (levels - level - 1) * height
+            hue = sum(ord(c) for c in part) % 40
+            label = part if w > len(part) * 7 else ''
+            rects.append('<g><title>%s %d (%.1f%%)</title>'
+                         '<rect x="%.1f" y="%d" width="%.1f" height="%d" fill="hsl(%d,90%%,60%%)" stroke="white"/>'
+                         '<text x="%.1f" y="%d" font-size="12" font-family="monospace">%s</text></g>'
+                         % (part, child[0], child[0] * 100.0 / total, x, y, w, height - 1, hue, x + 3, y + height - 5, label))
+            draw(child, x, level + 1)
+            x += w
+
+    draw(root, 0, 0)
+    with open(path, 'w') as f:
+        f.write('<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d">\n' % (width, levels * height))
+        f.write('\n'.join(rects))
+        f.write('\n</svg>\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Count cycles from a function trace')
+    parser.add_argument('trace', help='trace with TRACE lines')
+    parser.add_argument('--us', action='store_true', help='the times are in microseconds (the ring buffer), not cycles')
+    parser.add_argument('--folded', help='write the stacks for flamegraph.pl to this file')
+    parser.add_argument('--svg', help='draw the flame graph to this file')
+    parser.add_argument('--chrome', help='write a Chrome trace timeline to this file')
+    args = parser.parse_args()
+
+    marks = read_trace(args.trace)
+    if not marks:
+        print('No trace')
+        sys.exit(1)
+    stats, stacks, calls, unmatched = profile(marks)
+    per_us = 1 if args.us else CPU_FREQ / 1000000.0
+    units = 'us' if args.us else 'cycles'
+    span = marks[-1][0] - marks[0][0]
+    print('%d marks over %d %s (%.3fs)' % (len(marks), span, units, span / per_us / 1000000.0))
+    print('%-18s %8s %12s %12s %8s %8s %8s' % ('function', 'calls', units, 'own', 'average', 'worst', 'worst us'))
+    for mark in sorted(stats, key=lambda m: -stats[m].total):
+        s = stats[mark]
+        print('%-18s %8d %12d %12d %8d %8d %8.1f' % (name(mark), s.calls, s.total, s.own, s.total // s.calls, s.worst,
+                                                     s.worst / per_us))
+    if unmatched:
+        print('%d marks unmatched' % unmatched)
+    if args.folded:
+        write_folded(stacks, args.folded)
+    if args.svg:
+        write_svg(stacks, args.svg)
+    if args.chrome:
+        write_chrome(calls, args.chrome, per_us)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,113 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+/*
+ * Function trace ring buffer
+ * Marks come from the loop and the sound interrupt, so interrupts are held
+ * off while one is added. Only the time since the mark before is kept, to
+ * save RAM - the times are worked out again, backwards from the last mark,
+ * when they're printed.
+ * Only enabled when TRACE_RAM is defined in trace.h
+ */
+#include "trace.h"
+
+#ifdef TRACE_RAM
+
+Trace trace;
+
+void Trace::mark (uint8_t m) {
+#ifndef HAL_HOST
+  // This might be in an interrupt, so put interrupts back the way they were
+  uint8_t oldSREG = SREG;
+  cli ();
+#endif
+  if (!paused) {
+    unsigned long now = Clock::micros ();
+    unsigned long ticks = (now - lastTime) / TRACE_RAM_TICK;
+    if (ticks >= 0xFFFF) {
+      ticks = 0xFFFF;
+      lastTime = now;
+    } else {
+      // Keep the remainder, so the times don't drift
+      lastTime += ticks * TRACE_RAM_TICK;
+    }
+    ring[head].mark = m;
+    ring[head].ticks = ticks;
+    head = (head + 1) % TRACE_RAM_SIZE;
+    if (count < TRACE_RAM_SIZE) count ++;
+  }
+#ifndef HAL_HOST
+  SREG = oldSREG;
+#endif
+}
+
+/*
+ * A 't' over the serial port asks for the marks
+ */
+void Trace::poll () {
+  if (Serial.available () && Serial.read () == 't') dump ();
+}
+
+/*
+ * Print the marks over the serial port, oldest first, and start again
+ * Format:
+ * TRACES 64
+ * TRACE 1203340 1      (time in microseconds, then the mark)
+ * TRACE 1203352 10
+ * TRACE 1203500 138
+ * ...
+ * A time after a gap of more than a quarter of a second is too early.
+ */
+void Trace::dump () {
+  dumpStart ();
+  while (dumpLine ()) ;
+}
+
+/*
+ * The same, a line at a time (for the console, which prints a line a frame)
+ * Nothing is recorded until the last line has gone, so the marks printed
+ * are the ones from when they were asked for.
+ */
+void Trace::dumpStart () {
+  noInterrupts ();
+  paused = true;
+  interrupts ();
+  // Work back from the last mark to the time of the first
+  uint8_t first = (head + TRACE_RAM_SIZE - count) % TRACE_RAM_SIZE;
+  dumpTime = lastTime;
+  for (uint8_t i = 1; i < count; i ++) {
+    dumpTime -= (unsigned long)ring[(first + i) % TRACE_RAM_SIZE].ticks * TRACE_RAM_TICK;
+  }
+  dumped = 0;
+}
+
+boolean Trace::dumpLine () {
+  if (dumped == 0) {
+    Serial.print (F("TRACES "));
+    Serial.println (count);
+  } else {
+    uint8_t i = dumped - 1;
+    const TraceRecord &r = ring[(head + TRACE_RAM_SIZE - count + i) % TRACE_RAM_SIZE];
+    if (i) dumpTime += (unsigned long)r.ticks * TRACE_RAM_TICK;
+    Serial.print (F("TRACE "));
+    Serial.print (dumpTime);
+    Serial.print (' ');
+    Serial.println (r.mark);
+  }
+  if (dumped ++ < count) return (true);
+  // All printed, so start again
+  noInterrupts ();
+  count = 0;
+  paused = false;
+  interrupts ();
+  return (false);
+}
+
+#endif
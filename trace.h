@@ -0,0 +1,141 @@
+/*******************************************************************************
+*                                                                              *
+* Author: Nicholaus D. Cranch (N.I.X Consulting)                               *
+* e-mail: info@nix-consulting.co.uk                                            *
+*                                                                              *
+* The following code may be used freely for personal, demonstration and        *
+* teaching purposes only. Permission will be required for commercial use, as   *
+* stipulated by GNU GPLv3.                                                     *
+*                                                                              *
+*******************************************************************************/
+#ifndef trace_h
+#define trace_h
+#include <Arduino.h>
+#include "hal.h"
+
+/*
+ * Marks when the functions below start and finish, to see where the time
+ * goes. There are two ways of recording them - uncomment one:
+ *
+ * TRACE_SIM - for counting cycles with the firmware running under simavr
+ * (see tools/avr_sim.c). Each mark is a single write of the function's
+ * number to GPIOR0, a spare register nothing else uses, so it costs a cycle.
+ * The simulator watches the register and logs the cycle count of each write.
+ * AVR only.
+ *
+ * TRACE_RAM - for the real board (or the host). Each mark goes into a ring
+ * buffer in RAM, with the time since the mark before, so it always holds the
+ * last TRACE_RAM_SIZE of them. Send a 't' over the serial port (or the
+ * trace command, with the console - see console.h) and they're printed (see
+ * Trace::dump). Each mark takes a few microseconds, mostly micros (), and
+ * the ring takes 3 bytes a mark of RAM.
+ *
+ * Either way, tools/trace_profile.py turns the marks into times for each
+ * function, a flame graph or a Chrome trace timeline.
+ */
+//#define TRACE_SIM
+//#define TRACE_RAM
+#define TRACE_RAM_SIZE 64           // Marks kept (3 bytes each)
+#define TRACE_RAM_TICK 4            // Microseconds per tick of the time between marks (micros () goes up in 4s on an Uno)
+
+// What is traced (tools/trace_profile.py has the same list)
+#define TRACE_GAME_LOOP 1           // gameLoop ()
+#define TRACE_UPDATE 2              // SSD1306::update ()
+#define TRACE_DRAW_BITMAP 3         // SSD1306::drawBitmap () (TRACE_SIM only)
+#define TRACE_SEND 4                // Sending data to the display
+#define TRACE_ALIEN_COLLISION 5     // AlienGrid::collisionDetect ()
+#define TRACE_DEFENCE_COLLISION 6   // Defence::collisionDetect ()
+#define TRACE_BASE_COLLISION 7      // Base::collisionDetect ()
+#define TRACE_MYSTERY_COLLISION 8   // Mystery::collisionDetect ()
+#define TRACE_SOUND 9               // The sound interrupt (TRACE_SIM only)
+#define TRACE_ALIEN_STEP 10         // AlienGrid::step ()
+#define TRACE_BOMBS 11              // moveAndCreateBombs ()
+#define TRACE_SOUND_UPDATE 12       // Sound::update () - a voice's countdown ran out (TRACE_SIM only)
+
+#define TRACE_EXIT 0x80             // Set on the mark when the function finishes
+
+#if defined (TRACE_SIM) && defined (TRACE_RAM)
+#error Pick one of TRACE_SIM and TRACE_RAM
+#endif
+
+#ifdef TRACE_SIM
+#ifdef HAL_HOST
+#error TRACE_SIM is for the AVR
+#endif
+#define TRACE_MARK(m) GPIOR0 = (m)
+#endif
+
+#ifdef TRACE_RAM
+/*
+ * A mark in the ring buffer
+ */
+struct TraceRecord {
+  uint8_t mark;                     // The function, with TRACE_EXIT set when it finishes
+  uint16_t ticks;                   // TRACE_RAM_TICKs since the mark before (0xFFFF if longer)
+};
+
+class Trace {
+  public:
+    void mark (uint8_t m);          // Add a mark (from the loop or an interrupt)
+    void poll ();                   // Print the marks if they've been asked for
+    void dump ();                   // Print the marks and start again
+    void dumpStart ();              // ... or a line at a time - stop recording and get ready to print them
+    boolean dumpLine ();            // Print the next line - returns false when they're all done (and recording again)
+
+  private:
+    TraceRecord ring[TRACE_RAM_SIZE];
+    uint8_t head;                   // Where the next mark goes
+    uint8_t count;                  // Marks in the ring
+    boolean paused;                 // Not recording while the marks are printed
+    unsigned long lastTime;         // micros () at the last mark
+    uint8_t dumped;                 // Lines printed so far (the first is the count)
+    unsigned long dumpTime;         // The time of the next mark to print
+};
+
+extern Trace trace;
+
+#define TRACE_MARK(m) trace.mark (m)
+#define TRACE_POLL() trace.poll ()
+#endif
+
+#ifdef TRACE_MARK
+/*
+ * Marks the start of the function, and the finish when it goes out of scope
+ * (so every return is caught)
+ */
+class TraceScope {
+  public:
+    inline TraceScope (uint8_t id) : id (id) { TRACE_MARK (id); }
+    inline ~TraceScope () { TRACE_MARK (id | TRACE_EXIT); }
+
+  private:
+    uint8_t id;
+};
+
+#define TRACE_SCOPE(id) TraceScope traceScope (id)
+
+#else
+
+#define TRACE_SCOPE(id)
+
+#endif
+
+/*
+ * For things that happen too often for the ring - the sound interrupt runs
+ * 10000 times a second, and a frame can draw over 50 bitmaps. They'd push
+ * everything else out of it in no time (and the interrupt would spend much
+ * of its time in micros ()), so they're only traced under the simulator.
+ * With the ring, their time shows up in whatever they interrupted or were
+ * called from.
+ */
+#ifdef TRACE_SIM
+#define TRACE_SCOPE_SIM(id) TRACE_SCOPE (id)
+#else
+#define TRACE_SCOPE_SIM(id)
+#endif
+
+#ifndef TRACE_POLL
+#define TRACE_POLL()
+#endif
+
+#endif